@@ -150,7 +150,7 @@ unsigned char* bytesFromResource(const char* _path, unsigned int* _size) {
     return data;
 }
 
-bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
+bool startUrlRequest(const std::string& _url, UrlCallback _callback, float _priority) {
     
     jstring jUrl = jniEnv->NewStringUTF(_url.c_str());
 
@@ -158,7 +158,7 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     // to a Java type. We allocate a new callback object and then reinterpret the pointer to it as a Java long. 
     // In Java, we associate this long with the current network request and pass it back to native code when
     // the request completes (either in onUrlSuccess or onUrlFailure), reinterpret the long back into a
-    // pointer, call the callback function if the request succeeded, and delete the heap-allocated UrlCallback 
+    // pointer, call the callback function, with empty data if the request failed, and delete the heap-allocated UrlCallback 
     // to make sure nothing is leaked. 
     jlong jCallbackPtr = reinterpret_cast<jlong>(new UrlCallback(_callback));
 
@@ -167,6 +167,12 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return methodResult;
 }
 
+void setUrlRequestPriority(const std::string& _url, float _priority) {
+
+    // OkHttp dispatches requests in the order they were made
+
+}
+
 void cancelUrlRequest(const std::string& _url) {
 
     jstring jUrl = jniEnv->NewStringUTF(_url.c_str());
@@ -192,6 +198,7 @@ void onUrlSuccess(JNIEnv* _jniEnv, jbyteArray _jBytes, jlong _jCallbackPtr) {
 void onUrlFailure(JNIEnv* _jniEnv, jlong _jCallbackPtr) {
 
     UrlCallback* callback = reinterpret_cast<UrlCallback*>(_jCallbackPtr);
+    (*callback)(std::vector<char>());
     delete callback;
 
 }
@@ -0,0 +1,194 @@
+#include "archiveSource.h"
+#include "platform.h"
+#include "tileManager.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+    uint32_t readUint32(const char* _data) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(_data);
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    uint64_t readUint64(const char* _data) {
+        return uint64_t(readUint32(_data)) | (uint64_t(readUint32(_data + 4)) << 32);
+    }
+
+    // Order of the directory entries: z, then x, then y, all ascending
+    bool isBefore(const TileID& _a, const TileID& _b) {
+        return _a.z < _b.z || (_a.z == _b.z && (_a.x < _b.x || (_a.x == _b.x && _a.y < _b.y)));
+    }
+
+    bool isGzipped(const char* _data, size_t _size) {
+        return _size > 2 && (unsigned char)_data[0] == 0x1f && (unsigned char)_data[1] == 0x8b;
+    }
+
+    bool inflateGzip(const char* _data, size_t _size, std::vector<char>& _out) {
+
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+
+        // 16 + MAX_WBITS selects the gzip header
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+            return false;
+        }
+
+        stream.next_in = (Bytef*)_data;
+        stream.avail_in = _size;
+
+        _out.resize(_size * 4);
+
+        int status = Z_OK;
+        while (status == Z_OK) {
+            if (stream.total_out == _out.size()) {
+                _out.resize(_out.size() * 2);
+            }
+            stream.next_out = (Bytef*)(_out.data() + stream.total_out);
+            stream.avail_out = _out.size() - stream.total_out;
+            status = inflate(&stream, Z_NO_FLUSH);
+        }
+
+        _out.resize(stream.total_out);
+        inflateEnd(&stream);
+
+        return status == Z_STREAM_END;
+    }
+
+}
+
+ArchiveSource::ArchiveSource(const std::string& _name, const std::string& _path) :
+    MVTSource(_name, _path) {
+
+    if (!open(_path)) {
+        logMsg("ERROR: Cannot read tile archive %s\n", _path.c_str());
+    }
+
+}
+
+ArchiveSource::~ArchiveSource() {
+
+    if (m_data) {
+        munmap((void*)m_data, m_size);
+    }
+
+}
+
+bool ArchiveSource::open(const std::string& _path) {
+
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)s_headerSize) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping stays valid after the file is closed
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = info.st_size;
+
+    uint32_t version = readUint32(m_data + 4);
+    uint32_t count = readUint32(m_data + 8);
+
+    if (std::memcmp(m_data, "TGTA", 4) != 0 || version != 1 || s_headerSize + (uint64_t)count * s_entrySize > m_size) {
+        munmap(data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+
+    m_directory = m_data + s_headerSize;
+    m_tileCount = count;
+
+    // Tiles are read in the order they are needed by the view
+    madvise(data, m_size, MADV_RANDOM);
+
+    return true;
+}
+
+const char* ArchiveSource::findTile(const TileID& _tileID, size_t& _size) const {
+
+    // Binary search of the directory, in the order of the file format rather than of TileID
+    uint32_t first = 0, last = m_tileCount;
+
+    while (first < last) {
+
+        uint32_t middle = first + (last - first) / 2;
+        const char* entry = m_directory + (size_t)middle * s_entrySize;
+
+        TileID id(readUint32(entry + 4), readUint32(entry + 8), readUint32(entry));
+
+        if (isBefore(id, _tileID)) {
+            first = middle + 1;
+        } else if (isBefore(_tileID, id)) {
+            last = middle;
+        } else {
+            uint32_t length = readUint32(entry + 12);
+            uint64_t offset = readUint64(entry + 16);
+            if (offset + length > m_size) {
+                logMsg("ERROR: Tile [%d, %d, %d] is out of the bounds of the archive\n", _tileID.z, _tileID.x, _tileID.y);
+                return nullptr;
+            }
+            _size = length;
+            return m_data + offset;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ArchiveSource::loadTileData(const TileID& _tileID, TileManager& _tileManager) {
+
+    std::shared_ptr<TileData> tileData = getTileData(_tileID);
+
+    if (tileData) {
+        _tileManager.addToWorkerQueue(tileData, _tileID, this);
+        return true;
+    }
+
+    if (!m_data) {
+        return false;
+    }
+
+    // The tile is read from the mapped archive when it is parsed, on a worker thread
+    _tileManager.addToWorkerQueue(std::vector<char>(), _tileID, this);
+
+    return true;
+}
+
+std::shared_ptr<TileData> ArchiveSource::parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const {
+
+    size_t size = 0;
+    const char* data = m_data ? findTile(_tile.getID(), size) : nullptr;
+
+    if (!data) {
+        return std::make_shared<TileData>();
+    }
+
+    if (isGzipped(data, size)) {
+        if (!inflateGzip(data, size, _rawData)) {
+            logMsg("ERROR: Cannot decompress tile [%d, %d, %d]\n", _tile.getID().z, _tile.getID().x, _tile.getID().y);
+            return std::make_shared<TileData>();
+        }
+        return parseMvt(_tile, _rawData.data(), _rawData.size(), _cancel);
+    }
+
+    return parseMvt(_tile, data, size, _cancel);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "mvtSource.h"
+
+/* Reads vector tiles from a local, read-only tile archive
+ *
+ * The archive is a single file, memory-mapped so that tiles are parsed in place:
+ *  - a header of 12 bytes: the characters "TGTA", the format version (1) and the number of tiles, as
+ *    little-endian 32 bit integers;
+ *  - a directory with an entry of 24 bytes per tile: z, x, y and the length of the tile data as 32 bit
+ *    integers, then the offset of the tile data from the start of the file as a 64 bit integer, all
+ *    little-endian; entries are sorted by z, then x, then y, all ascending (unlike <TileID>, which sorts
+ *    z descending);
+ *  - the data of the tiles, in the Mapbox vector tile format, each optionally compressed with gzip.
+ *
+ * Tiles that are not in the archive are built without data.
+ */
+class ArchiveSource : public MVTSource {
+
+public:
+
+    /* Opens the archive at the file path @_path; if it can't be read, the source provides no tiles */
+    ArchiveSource(const std::string& _name, const std::string& _path);
+
+    virtual ~ArchiveSource();
+
+    virtual bool loadTileData(const TileID& _tileID, TileManager& _tileManager) override;
+
+    /* Tiles are read from the archive by the tile workers, so there is no request to cancel */
+    virtual void cancelLoadingTile(const TileID& _tileID) override {}
+
+    /* Tiles are not requested, so they have no request priority */
+    virtual void setTilePriority(const TileID& _tileID, float _priority) override {}
+
+protected:
+
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override;
+
+private:
+
+    bool open(const std::string& _path);
+
+    /* Returns the data of @_tileID in the archive and sets @_size to its length, or returns null */
+    const char* findTile(const TileID& _tileID, size_t& _size) const;
+
+    const char* m_data = nullptr; // Mapped archive file
+    size_t m_size = 0;
+
+    const char* m_directory = nullptr;
+    uint32_t m_tileCount = 0;
+
+    static const size_t s_headerSize = 12;
+    static const size_t s_entrySize = 24;
+
+};
@@ -0,0 +1,260 @@
+#include "clientGeoJsonSource.h"
+#include "platform.h"
+#include "tileData.h"
+#include "mapTile.h"
+#include "tileManager.h"
+#include "util/geoJsonReader.h"
+#include "util/simplification.h"
+
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/encodings.h"
+#include "rapidjson/encodedstream.h"
+
+#include <cstdlib>
+
+constexpr float ClientGeoJsonSource::s_simplifyTolerance;
+
+ClientGeoJsonSource::ClientGeoJsonSource(const std::string& _name, const std::string& _url) :
+    DataSource(_name, _url) {
+
+    m_maxZoom = s_defaultMaxZoom;
+    m_simplifyTolerance = 0;
+
+}
+
+bool ClientGeoJsonSource::isRemote() const {
+
+    return m_urlTemplate.find("://") != std::string::npos;
+
+}
+
+bool ClientGeoJsonSource::loadTileData(const TileID& _tileID, TileManager& _tileManager) {
+
+    std::shared_ptr<TileData> tileData = getTileData(_tileID);
+
+    if (tileData) {
+        _tileManager.addToWorkerQueue(tileData, _tileID, this);
+        return true;
+    }
+
+    if (isRemote()) {
+
+        std::unique_lock<std::mutex> lock(m_loadMutex);
+
+        if (m_loadState != LoadState::loaded) {
+
+            m_pendingTiles.insert(_tileID);
+
+            if (m_loadState == LoadState::loading) {
+                return true;
+            }
+
+            m_loadState = LoadState::loading;
+            lock.unlock();
+
+            bool started = startUrlRequest(m_urlTemplate, [this, &_tileManager](std::vector<char>&& _rawData) {
+
+                std::set<TileID> pending;
+
+                if (_rawData.empty()) {
+                    // The request failed; the file is requested again when a tile is reloaded
+                    logMsg("ERROR: Loading failed for %s\n", m_urlTemplate.c_str());
+                    std::lock_guard<std::mutex> lock(m_loadMutex);
+                    m_loadState = LoadState::idle;
+                    m_pendingTiles.clear();
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_loadMutex);
+                    m_rawData = std::move(_rawData);
+                    m_loadState = LoadState::loaded;
+                    std::swap(pending, m_pendingTiles);
+                }
+
+                // The file is indexed by the worker that builds the first of these tiles
+                for (const auto& id : pending) {
+                    _tileManager.addToWorkerQueue(std::vector<char>(), id, this);
+                }
+                requestRender();
+
+            });
+
+            if (!started) {
+                lock.lock();
+                m_loadState = LoadState::idle;
+                m_pendingTiles.clear();
+            }
+
+            return started;
+        }
+    }
+
+    // Tiles are cut from the index by the tile workers
+    _tileManager.addToWorkerQueue(std::vector<char>(), _tileID, this);
+
+    return true;
+}
+
+void ClientGeoJsonSource::cancelLoadingTile(const TileID& _tileID) {
+
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+
+    // The file itself is still loaded for the remaining and future tiles
+    m_pendingTiles.erase(_tileID);
+
+}
+
+std::shared_ptr<TileData> ClientGeoJsonSource::parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const {
+
+    {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+
+        if (!m_indexed) {
+            buildIndex(_tile);
+        }
+    }
+
+    return getTile(_tile.getID());
+}
+
+void ClientGeoJsonSource::buildIndex(const MapTile& _tile) const {
+
+    m_indexed = true;
+
+    // The file, which may be large, is parsed from the buffer it was read or downloaded into, without a copy
+    std::vector<char> data;
+    unsigned char* bytes = nullptr;
+    unsigned int size = 0;
+
+    if (isRemote()) {
+        std::swap(data, m_rawData);
+    } else {
+        bytes = bytesFromResource(m_urlTemplate.c_str(), &size);
+    }
+
+    const char* json = bytes ? reinterpret_cast<const char*>(bytes) : data.data();
+    size_t length = bytes ? size : data.size();
+
+    std::shared_ptr<TileData> root = std::make_shared<TileData>();
+
+    // All features are read in the coordinates of the tile [0, 0, 0]; the index is shared by all tiles,
+    // so reading is not canceled with the tile that happens to build it
+    MapTile world(TileID(0, 0, 0), *_tile.getProjection());
+    GeoJsonReader handler(*root, world, CancelToken::none(), m_name);
+    rapidjson::Reader reader;
+
+    rapidjson::MemoryStream ms(json, length);
+    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> is(ms);
+
+    reader.Parse(is, handler);
+
+    std::free(bytes);
+    std::vector<char>().swap(data);
+
+    if (reader.HasParseError()) {
+        const char* error = rapidjson::GetParseError_En(reader.GetParseErrorCode());
+        logMsg("ERROR: Json parsing failed on %s: %s (%zu)\n", m_urlTemplate.c_str(), error, reader.GetErrorOffset());
+    }
+
+    root->memory.set(root->getMemoryUsage());
+    m_index[TileID(0, 0, 0)].source = root;
+
+}
+
+std::shared_ptr<TileData> ClientGeoJsonSource::getTile(const TileID& _tileID) const {
+
+    // Split tiles down to the requested one, one level at a time
+    while (true) {
+
+        std::shared_ptr<TileData> source;
+        int z = _tileID.z;
+
+        {
+            std::lock_guard<std::mutex> lock(m_indexMutex);
+
+            // Closest indexed tile on the path from the root to the requested tile
+            auto it = m_index.find(_tileID);
+            while (it == m_index.end() && z > 0) {
+                it = m_index.find(_tileID.getAncestor(--z));
+            }
+
+            if (it == m_index.end()) {
+                return std::make_shared<TileData>();
+            }
+
+            if (!it->second.source) {
+                if (z < _tileID.z) {
+                    // Split before, and its children with features were indexed
+                    return std::make_shared<TileData>();
+                }
+                return it->second.features ? it->second.features : std::make_shared<TileData>();
+            }
+
+            source = it->second.source;
+        }
+
+        // Sources of indexed tiles are not changed, so tiles are simplified and split outside of the lock
+        if (z == _tileID.z) {
+            return simplify(*source);
+        }
+
+        bool empty = true;
+        for (const auto& layer : source->layers) {
+            empty = empty && layer.features.empty();
+        }
+        if (empty) {
+            // All tiles below an empty tile are empty
+            return std::make_shared<TileData>();
+        }
+
+        TileID id = _tileID.getAncestor(z);
+
+        std::shared_ptr<TileData> children[4];
+        for (int i = 0; i < 4; i++) {
+            children[i] = sliceTileData(*source, id, id.getChild(i));
+            children[i]->memory.set(children[i]->getMemoryUsage());
+        }
+
+        // Only the simplified features are kept for tiles that were split
+        std::shared_ptr<TileData> features = simplify(*source);
+        features->memory.set(features->getMemoryUsage());
+
+        {
+            std::lock_guard<std::mutex> lock(m_indexMutex);
+
+            // Another worker may have split the tile in the meantime; its children are used then
+            IndexTile& parent = m_index[id];
+            if (parent.source == source) {
+                for (int i = 0; i < 4; i++) {
+                    m_index[id.getChild(i)].source = children[i];
+                }
+                // The index may have been rehashed by the new children
+                IndexTile& split = m_index[id];
+                split.features = features;
+                split.source.reset();
+            }
+        }
+    }
+}
+
+std::shared_ptr<TileData> ClientGeoJsonSource::simplify(const TileData& _source) const {
+
+    std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
+
+    for (const auto& layer : _source.layers) {
+
+        tileData->layers.emplace_back(layer.name);
+        Layer& out = tileData->layers.back();
+
+        for (const auto& feature : layer.features) {
+            Feature simplified = feature;
+            if (Simplification::simplifyFeature(simplified, s_simplifyTolerance)) {
+                out.features.push_back(std::move(simplified));
+            }
+        }
+    }
+
+    return tileData;
+}
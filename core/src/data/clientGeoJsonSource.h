@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "dataSource.h"
+
+/* Serves tiles cut on the client from a single, untiled GeoJSON file
+ *
+ * The file, a feature collection, is read once when the first tile is needed: a local path is read by
+ * the tile workers, a URL is requested once. Its features form the index tile [0, 0, 0]; requested tiles
+ * are split from their closest indexed ancestor on demand, each split clipping the features to the four
+ * children with a small buffer. Tiles are served simplified with a tolerance in tile units, so that
+ * detail matches the zoom of the tile. The index keeps the unsimplified features of the tiles that were
+ * not split yet and the simplified features of the tiles that were.
+ *
+ * Features are kept in single precision, so tiles are only cut down to <s_defaultMaxZoom> unless the scene
+ * sets another maximum zoom; deeper tiles are sliced from those as for other sources.
+ */
+class ClientGeoJsonSource : public DataSource {
+
+public:
+
+    /* @_url is the path or URL of the GeoJSON file; its features are put in a layer named @_name */
+    ClientGeoJsonSource(const std::string& _name, const std::string& _url);
+
+    virtual bool loadTileData(const TileID& _tileID, TileManager& _tileManager) override;
+
+    virtual void cancelLoadingTile(const TileID& _tileID) override;
+
+    /* Tiles are not requested individually */
+    virtual void setTilePriority(const TileID& _tileID, float _priority) override {}
+
+    /* Tiles are simplified with <s_simplifyTolerance> as the index is split, and share their data with the
+     * index, so they are not simplified again after parsing */
+    virtual void setSimplifyTolerance(float _pixels) override {}
+
+    static const int s_defaultMaxZoom = 14;
+
+    // Simplification tolerance in tile units, where a tile is 2 units wide; about 3 units of a 4096 extent
+    static constexpr float s_simplifyTolerance = 0.0015f;
+
+protected:
+
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override;
+
+private:
+
+    struct IndexTile {
+        std::shared_ptr<TileData> source;   // Unsimplified features, until the tile is split
+        std::shared_ptr<TileData> features; // Simplified features, once the tile is split
+    };
+
+    bool isRemote() const;
+
+    /* Reads the file into the index tile [0, 0, 0]; m_indexMutex must be held */
+    void buildIndex(const MapTile& _tile) const;
+
+    /* Returns the simplified features of @_tileID, splitting indexed tiles as needed */
+    std::shared_ptr<TileData> getTile(const TileID& _tileID) const;
+
+    /* Returns a copy of @_source with simplified geometry */
+    std::shared_ptr<TileData> simplify(const TileData& _source) const;
+
+    mutable std::mutex m_indexMutex;
+    mutable std::unordered_map<TileID, IndexTile> m_index;
+    mutable bool m_indexed = false;
+
+    // Loading of a remote file
+    enum class LoadState { idle, loading, loaded };
+    std::mutex m_loadMutex;
+    LoadState m_loadState = LoadState::idle;
+    std::set<TileID> m_pendingTiles; // Tiles waiting for the file
+    mutable std::vector<char> m_rawData;
+
+};
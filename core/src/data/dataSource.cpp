@@ -1,47 +1,147 @@
 #include "geoJson.h"
 #include "dataSource.h"
+#include "diskCache.h"
+#include "requestCoalescer.h"
 #include "platform.h"
 #include "tileID.h"
 #include "tileData.h"
 #include "mapTile.h"
 #include "tileManager.h"
 #include "labels/labelContainer.h"
+#include "util/clipping.h"
+#include "util/simplification.h"
+#include "view/view.h"
+
+#include <algorithm>
 
 //---- DataSource Implementation----
 
+constexpr float DataSource::s_overzoomBuffer;
+constexpr float DataSource::s_defaultSimplifyTolerance;
+const size_t DataSource::s_defaultStoreBudget;
+
 DataSource::DataSource(const std::string& _name, const std::string& _urlTemplate) :
-    m_name(_name), m_urlTemplate(_urlTemplate) {
+    m_name(_name), m_maxZoom(View::s_maxZoom), m_urlTemplate(_urlTemplate) {
 
 }
 
 bool DataSource::hasTileData(const TileID& _tileID) const {
     
-    return m_tileStore.find(_tileID) != m_tileStore.end();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_tileStore.find(getDataTileID(_tileID)) != m_tileStore.end();
 }
 
 std::shared_ptr<TileData> DataSource::getTileData(const TileID& _tileID) const {
     
-    const auto it = m_tileStore.find(_tileID);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_tileStore.find(getDataTileID(_tileID));
     
     if (it != m_tileStore.end()) {
-        std::shared_ptr<TileData> tileData = it->second;
-        return tileData;
+        m_storeOrder.splice(m_storeOrder.begin(), m_storeOrder, it->second.lru);
+        return it->second.data;
     } else {
         return nullptr;
     }
 }
 
 void DataSource::clearData() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     for (auto& mapValue : m_tileStore) {
-        mapValue.second->layers.clear();
+        mapValue.second.data->layers.clear();
     }
     m_tileStore.clear();
+    m_storeOrder.clear();
+    m_storeBytes = 0;
 }
 
 void DataSource::setTileData(const TileID& _tileID, const std::shared_ptr<TileData>& _tileData) {
-    
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_tileStore[_tileID] = _tileData;
+
+    // Parsing may fail without any data
+    if (!_tileData) {
+        return;
+    }
+
+    size_t bytes = _tileData->getMemoryUsage();
+    _tileData->memory.set(bytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_tileStore.find(_tileID);
+    if (it != m_tileStore.end()) {
+        eraseStored(it);
+    }
+
+    // Data larger than the whole budget is not kept, the tile task that parsed it still uses it
+    if (bytes > m_storeBudget) {
+        return;
+    }
+
+    evictStore(m_storeBudget - bytes);
+
+    m_storeOrder.push_front(_tileID);
+    m_tileStore.emplace(_tileID, StoredData{ _tileData, bytes, m_storeOrder.begin() });
+    m_storeBytes += bytes;
+}
+
+void DataSource::setStoreBudget(size_t _bytes) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_storeBudget = _bytes;
+    evictStore(_bytes);
+
+}
+
+size_t DataSource::getStoreSize() const {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_storeBytes;
+}
+
+void DataSource::evictStore(size_t _bytes) {
+
+    while (m_storeBytes > _bytes && !m_storeOrder.empty()) {
+        eraseStored(m_tileStore.find(m_storeOrder.back()));
+    }
+
+}
+
+void DataSource::eraseStored(std::unordered_map<TileID, StoredData>::iterator _it) {
+
+    m_storeBytes -= _it->second.bytes;
+    m_storeOrder.erase(_it->second.lru);
+    m_tileStore.erase(_it);
+
+}
+
+size_t DataSource::evictTileData(size_t _bytes, const std::function<bool(const TileID&)>& _keep) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t freed = 0;
+
+    // Least recently used data goes first
+    auto it = m_storeOrder.end();
+    while (it != m_storeOrder.begin() && freed < _bytes) {
+        --it;
+        auto stored = m_tileStore.find(*it);
+        if (_keep(stored->first)) {
+            continue;
+        }
+        // Memory is only released here if no tile task still uses the data
+        if (stored->second.data.use_count() == 1) {
+            freed += stored->second.data->memory.get();
+        }
+        it = std::next(it);
+        eraseStored(stored);
+    }
+
+    return freed;
 }
 
 void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const {
@@ -49,13 +149,19 @@ void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const
     _url.assign(m_urlTemplate);
 
     size_t xpos = _url.find("{x}");
-    _url.replace(xpos, 3, std::to_string(_tileCoord.x));
+    if (xpos != std::string::npos) {
+        _url.replace(xpos, 3, std::to_string(_tileCoord.x));
+    }
     
     size_t ypos = _url.find("{y}");
-    _url.replace(ypos, 3, std::to_string(_tileCoord.y));
+    if (ypos != std::string::npos) {
+        _url.replace(ypos, 3, std::to_string(_tileCoord.y));
+    }
     
     size_t zpos = _url.find("{z}");
-    _url.replace(zpos, 3, std::to_string(_tileCoord.z));
+    if (zpos != std::string::npos) {
+        _url.replace(zpos, 3, std::to_string(_tileCoord.z));
+    }
     
     if (xpos == std::string::npos || ypos == std::string::npos || zpos == std::string::npos) {
         logMsg("Bad URL template!!\n");
@@ -65,32 +171,147 @@ void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const
 bool DataSource::loadTileData(const TileID& _tileID, TileManager& _tileManager) {
     
     bool success = true; // Begin optimistically
+
+    std::shared_ptr<TileData> tileData = getTileData(_tileID);
     
-    if (hasTileData(_tileID)) {
-        _tileManager.addToWorkerQueue(m_tileStore[_tileID], _tileID, this);
+    if (tileData) {
+        _tileManager.addToWorkerQueue(tileData, _tileID, this);
         return success;
     }
 
     std::string url;
     
-    constructURL(_tileID, url);
+    // Overzoomed tiles request the data of their ancestor, which the worker slices for them
+    constructURL(getDataTileID(_tileID), url);
+
+    // Taken here, on the main thread, also for a request made from the I/O thread of the disk cache
+    float priority = _tileManager.getTilePriority(_tileID);
+
+    if (m_diskCache && m_diskCache->get(url, this, _tileID, [=,&_tileManager](std::vector<char>&& _rawData) {
+            if (_rawData.empty()) {
+                // The entry was dropped or couldn't be read, so the data is requested after all
+                requestTileData(url, _tileID, _tileManager, priority);
+                return;
+            }
+            _tileManager.addToWorkerQueue(std::move(_rawData), _tileID, this);
+            requestRender();
+        })) {
+        return success;
+    }
+
+    return requestTileData(url, _tileID, _tileManager, priority);
+}
+
+bool DataSource::requestTileData(const std::string& _url, const TileID& _tileID, TileManager& _tileManager, float _priority) {
 
-    success = startUrlRequest(url, [=,&_tileManager](std::vector<char>&& _rawData) {
+    std::shared_ptr<DiskCache> cache = m_diskCache;
+
+    // Tiles sharing the URL, e.g. overzoomed siblings or sources with the same URL template, share the request
+    return RequestCoalescer::GetInstance().request(_url, this, _tileID, [=,&_tileManager](std::vector<char>&& _rawData) {
         
         // _tileManager is captured here by reference, since its lifetime is the entire program lifetime,
         // but _tileID has to be captured by copy since it is a temporary stack object
+
+        if (_rawData.empty()) {
+            // The request failed; nothing is stored, so the tile requests the data again when it is reloaded
+            logMsg("ERROR: Loading failed for tile [%d, %d, %d]\n", _tileID.z, _tileID.x, _tileID.y);
+            return;
+        }
         
+        if (cache) {
+            cache->put(_url, _rawData);
+        }
+
         _tileManager.addToWorkerQueue(std::move(_rawData), _tileID, this);
         requestRender();
         
-    });
-    
-    return success;
+    }, _priority);
 }
 
 void DataSource::cancelLoadingTile(const TileID& _tileID) {
     std::string url;
-    constructURL(_tileID, url);
-    cancelUrlRequest(url);
+    constructURL(getDataTileID(_tileID), url);
+    // The request is only canceled once no other tile waits for it
+    RequestCoalescer::GetInstance().cancel(url, this, _tileID);
+    if (m_diskCache) {
+        m_diskCache->cancel(url, this, _tileID);
+    }
 }
 
+void DataSource::setTilePriority(const TileID& _tileID, float _priority) {
+    std::string url;
+    constructURL(getDataTileID(_tileID), url);
+    RequestCoalescer::GetInstance().setPriority(url, this, _tileID, _priority);
+}
+
+TileID DataSource::getDataTileID(const TileID& _tileID) const {
+
+    return _tileID.getAncestor(m_maxZoom);
+
+}
+
+std::shared_ptr<TileData> DataSource::sliceTileData(const TileData& _data, const TileID& _dataID, const TileID& _tileID) const {
+
+    std::shared_ptr<TileData> sliced = std::make_shared<TileData>();
+
+    // Number of tiles along each axis of the data tile at the zoom of the target tile
+    int dz = _tileID.z - _dataID.z;
+    float scale = float(1 << dz);
+
+    // Center of the target tile in the coordinates of the data tile; y is up while tile rows go down
+    int col = _tileID.x - (_dataID.x << dz);
+    int row = _tileID.y - (_dataID.y << dz);
+    glm::vec3 center(-1.f + (2 * col + 1) / scale, 1.f - (2 * row + 1) / scale, 0.f);
+
+    // Bounds of the target tile with its buffer, in the coordinates of the data tile
+    glm::vec4 bounds = Clipping::getTileBounds(s_overzoomBuffer) / scale + glm::vec4(center.x, center.y, center.x, center.y);
+
+    for (const auto& layer : _data.layers) {
+
+        sliced->layers.emplace_back(layer.name);
+        Layer& out = sliced->layers.back();
+
+        for (const auto& feature : layer.features) {
+
+            Feature clipped;
+            if (!Clipping::clipFeature(feature, bounds, clipped)) {
+                continue;
+            }
+
+            // Rescale to the coordinates of the target tile, including normalized heights
+            auto transform = [&](Point& _point) { _point = (_point - center) * scale; };
+
+            for (auto& point : clipped.points) { transform(point); }
+            for (auto& line : clipped.lines) {
+                for (auto& point : line) { transform(point); }
+            }
+            for (auto& polygon : clipped.polygons) {
+                for (auto& ring : polygon) {
+                    for (auto& point : ring) { transform(point); }
+                }
+            }
+
+            for (const char* key : { "height", "min_height" }) {
+                auto it = clipped.props.numericProps.find(key);
+                if (it != clipped.props.numericProps.end()) {
+                    it->second *= scale;
+                }
+            }
+
+            out.features.push_back(std::move(clipped));
+        }
+    }
+
+    return sliced;
+}
+
+void DataSource::simplifyTileData(TileData& _data, float _tolerance) {
+
+    for (auto& layer : _data.layers) {
+        auto& features = layer.features;
+        features.erase(std::remove_if(features.begin(), features.end(), [&](Feature& _feature) {
+            return !Simplification::simplifyFeature(_feature, _tolerance);
+        }), features.end());
+    }
+
+}
@@ -1,15 +1,20 @@
 #pragma once
 
+#include <functional>
+#include <list>
 #include <string>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
+#include "util/tileID.h"
+
 struct TileData;
-struct TileID;
+class DiskCache;
 class MapTile;
 class TileManager;
+class CancelToken;
 
 class DataSource {
     
@@ -35,32 +40,118 @@ public:
     /* Stops any running I/O tasks pertaining to @_tile */
     virtual void cancelLoadingTile(const TileID& _tile);
 
+    /* Sets the priority of the request for the data of @_tileID, if it is still waiting (see TileManager::getTilePriority) */
+    virtual void setTilePriority(const TileID& _tileID, float _priority);
+
     /* Checks if data exists for a specific <TileID> */
     virtual bool hasTileData(const TileID& _tileID) const;
 
-    /* Returns the data corresponding to a <TileID>, if it has been fetched already */
+    /* Returns the data corresponding to a <TileID>, if it has been fetched already; counts as a use of the data */
     virtual std::shared_ptr<TileData> getTileData(const TileID& _tileID) const;
     
-    /* Parse an I/O response into a <TileData>, returning an empty TileData on failure */
-    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData) const = 0;
+    /* Parse an I/O response into a <TileData>, returning an empty TileData on failure
+     *
+     * Parsing stops early once @_cancel is canceled; the returned data is then incomplete
+     */
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const = 0;
 
-    /* Stores tileData in m_tileStore */
+    /* Stores tileData in m_tileStore, evicting least recently used data beyond the store budget; null data is not stored */
     virtual void setTileData(const TileID& _tileID, const std::shared_ptr<TileData>& _tileData);
     
     /* Clears all data associated with this DataSource */
     void clearData();
 
+    /* Sets the estimated number of bytes of parsed data kept in m_tileStore, evicting data as needed */
+    void setStoreBudget(size_t _bytes);
+
+    size_t getStoreBudget() const { return m_storeBudget; }
+
+    /* Returns the estimated number of bytes of parsed data in m_tileStore */
+    size_t getStoreSize() const;
+
+    static const size_t s_defaultStoreBudget = 32 * 1024 * 1024;
+
+    /* Sets a persistent cache for the raw data of this source; cached tiles are read from it on a background
+     * thread instead of being requested, and requested tiles are added to it */
+    void setDiskCache(std::shared_ptr<DiskCache> _cache) { m_diskCache = _cache; }
+
+    /* Sets the highest zoom at which data is requested; tiles above it are sliced from the data of their
+     * ancestor at @_maxZoom instead of being requested */
+    void setMaxZoom(int _maxZoom) { m_maxZoom = _maxZoom; }
+
+    int getMaxZoom() const { return m_maxZoom; }
+
+    /* Sets the buffer around the tile, as a fraction of the tile size, to which geometry is clipped while it
+     * is parsed; a negative buffer, the default, keeps geometry as it is */
+    void setClipBuffer(float _buffer) { m_clipBuffer = _buffer; }
+
+    float getClipBuffer() const { return m_clipBuffer; }
+
+    /* Sets the tolerance, in pixels, with which lines and polygons are simplified after parsing; zero keeps
+     * geometry as it is */
+    virtual void setSimplifyTolerance(float _pixels) { m_simplifyTolerance = _pixels; }
+
+    float getSimplifyTolerance() const { return m_simplifyTolerance; }
+
+    /* Simplifies the lines and polygons of @_data in place with @_tolerance in tile units, dropping features
+     * with no geometry left */
+    static void simplifyTileData(TileData& _data, float _tolerance);
+
+    /* Returns the tile whose data is used for @_tileID: the tile itself or, above the maximum zoom, its ancestor */
+    TileID getDataTileID(const TileID& _tileID) const;
+
+    /* Clips the data @_data of the tile @_dataID to the area of its descendant @_tileID, with a small buffer,
+     * and scales it to the coordinates of @_tileID */
+    std::shared_ptr<TileData> sliceTileData(const TileData& _data, const TileID& _dataID, const TileID& _tileID) const;
+
+    /* Removes stored data for tiles not kept by @_keep until about @_bytes are released; returns the number of bytes released */
+    size_t evictTileData(size_t _bytes, const std::function<bool(const TileID&)>& _keep);
+
 protected:
 
     /* Constructs the URL of a tile using <m_urlTemplate> */
     virtual void constructURL(const TileID& _tileCoord, std::string& _url) const;
+
+    /* Requests the data of @_tileID from @_url with @_priority, adding it to the disk cache, if any, once loaded */
+    bool requestTileData(const std::string& _url, const TileID& _tileID, TileManager& _tileManager, float _priority);
     
-    std::map< TileID, std::shared_ptr<TileData> > m_tileStore; // Map of tileIDs to data for that tile
+    struct StoredData {
+        std::shared_ptr<TileData> data;
+        size_t bytes;
+        std::list<TileID>::iterator lru;
+    };
+
+    /* Removes least recently used data until the store fits in @_bytes; m_mutex must be held */
+    void evictStore(size_t _bytes);
+
+    /* Removes the data of @_tileID from the store; m_mutex must be held */
+    void eraseStored(std::unordered_map<TileID, StoredData>::iterator _it);
+
+    // Map of tileIDs to data for that tile; hits move the tile to the front of m_storeOrder
+    mutable std::unordered_map<TileID, StoredData> m_tileStore;
+    mutable std::list<TileID> m_storeOrder; // Tiles in m_tileStore, most recently used first
+    size_t m_storeBytes = 0;
+    size_t m_storeBudget = s_defaultStoreBudget;
     
     std::string m_name; // Name used to identify this source in the style sheet
 
-    std::mutex m_mutex; // Used to ensure safe access from async loading threads
+    int m_maxZoom; // Highest zoom of the tiles provided by the source, see <setMaxZoom>
+
+    float m_clipBuffer = -1.f; // See <setClipBuffer>
+
+    float m_simplifyTolerance = s_defaultSimplifyTolerance; // See <setSimplifyTolerance>
+
+    // Margin kept around sliced tiles, as a fraction of the tile size like <m_clipBuffer>, to avoid seams
+    // between tiles
+    static constexpr float s_overzoomBuffer = 0.025f;
+
+    // Half a pixel: detail below it is not visible
+    static constexpr float s_defaultSimplifyTolerance = 0.5f;
+
+    mutable std::mutex m_mutex; // Used to ensure safe access from async loading threads
 
     std::string m_urlTemplate; // URL template for requesting tiles from a network or filesystem
 
+    std::shared_ptr<DiskCache> m_diskCache; // Persistent cache of raw tile data keyed by URL, if any
+
 };
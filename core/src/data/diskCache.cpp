@@ -0,0 +1,545 @@
+#include "diskCache.h"
+#include "platform.h"
+#include "util/bufferPool.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+    const char s_indexMagic[4] = { 'T', 'G', 'D', 'C' };
+    const uint32_t s_indexVersion = 1;
+
+    template <typename T>
+    bool readValue(std::FILE* _file, T& _value) {
+        return std::fread(&_value, sizeof(T), 1, _file) == 1;
+    }
+
+    template <typename T>
+    bool writeValue(std::FILE* _file, const T& _value) {
+        return std::fwrite(&_value, sizeof(T), 1, _file) == 1;
+    }
+
+}
+
+DiskCache::DiskCache(const std::string& _directory, size_t _maxBytes, double _maxAge) :
+    m_dataPath(_directory + "/tiles.dat"), m_indexPath(_directory + "/tiles.idx"),
+    m_maxBytes(_maxBytes), m_maxAge(_maxAge) {
+}
+
+DiskCache::~DiskCache() {
+
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    flush();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    saveIndex();
+    if (m_dataFile) {
+        std::fclose(m_dataFile);
+    }
+
+}
+
+bool DiskCache::open() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_thread.joinable()) {
+        return true;
+    }
+
+    bool indexLoaded = loadIndex();
+
+    // Without a valid index the data can't be found, so the data file is started over
+    m_dataFile = indexLoaded ? std::fopen(m_dataPath.c_str(), "r+b") : nullptr;
+    if (!m_dataFile) {
+        m_index.clear();
+        m_lru.clear();
+        m_liveBytes = 0;
+        m_dataFile = std::fopen(m_dataPath.c_str(), "w+b");
+    }
+
+    if (!m_dataFile) {
+        logMsg("ERROR: Cannot open tile cache file %s\n", m_dataPath.c_str());
+        return false;
+    }
+
+    std::fseek(m_dataFile, 0, SEEK_END);
+    m_fileBytes = std::ftell(m_dataFile);
+
+    // Entries written after the data file was last synced, e.g. when the app was killed, are lost
+    for (auto it = m_lru.begin(); it != m_lru.end(); ) {
+        const Entry& entry = m_index[*it];
+        if (entry.offset + entry.size > m_fileBytes) {
+            m_liveBytes -= entry.size;
+            m_index.erase(*it);
+            it = m_lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_thread = std::thread(&DiskCache::run, this);
+
+    return true;
+}
+
+bool DiskCache::contains(const std::string& _url) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(_url);
+
+    return it != m_index.end() && !isExpired(it->second);
+}
+
+bool DiskCache::get(const std::string& _url, const void* _owner, const TileID& _tileID, Callback _callback) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_index.find(_url);
+        if (it == m_index.end() || !m_thread.joinable()) {
+            return false;
+        }
+
+        if (isExpired(it->second)) {
+            remove(_url);
+            return false;
+        }
+
+        // Mark the entry as most recently used
+        m_lru.splice(m_lru.end(), m_lru, it->second.lru);
+
+        m_jobs.push_back({ _url, {}, std::move(_callback), _owner, _tileID.x, _tileID.y, _tileID.z });
+    }
+
+    m_condition.notify_one();
+
+    return true;
+}
+
+void DiskCache::put(const std::string& _url, const std::vector<char>& _data) {
+
+    if (_data.empty() || _data.size() > m_maxBytes) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_thread.joinable()) {
+            return;
+        }
+
+        m_jobs.push_back({ _url, _data, nullptr, nullptr, 0, 0, 0 });
+    }
+
+    m_condition.notify_one();
+
+}
+
+void DiskCache::cancel(const std::string& _url, const void* _owner, const TileID& _tileID) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Reads of other tiles for the same URL, e.g. overzoomed siblings, are kept
+    for (auto it = m_jobs.begin(); it != m_jobs.end(); ) {
+        if (it->callback && it->url == _url && it->owner == _owner &&
+            it->x == _tileID.x && it->y == _tileID.y && it->z == _tileID.z) {
+            it = m_jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+}
+
+void DiskCache::clear() {
+
+    std::vector<Callback> reads;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& job : m_jobs) {
+            if (job.callback) {
+                reads.push_back(std::move(job.callback));
+            }
+        }
+        m_jobs.clear();
+        m_index.clear();
+        m_lru.clear();
+        m_liveBytes = 0;
+    }
+
+    // Pending reads have nothing left to read
+    for (auto& callback : reads) {
+        callback({});
+    }
+
+    // The space in the data file is reclaimed by the next compaction
+    saveIndex();
+
+}
+
+void DiskCache::flush() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_idle.wait(lock, [this] { return m_jobs.empty() && m_busy == 0; });
+
+}
+
+size_t DiskCache::getSize() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_liveBytes;
+}
+
+void DiskCache::run() {
+
+    while (true) {
+
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+
+            if (m_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy++;
+        }
+
+        if (job.callback) {
+            read(job);
+        } else {
+            write(job);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_idle.notify_all();
+    }
+
+}
+
+void DiskCache::read(Job& _job) {
+
+    uint64_t offset;
+    uint32_t size;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // The entry may have been evicted since it was requested
+        auto it = m_index.find(_job.url);
+        if (it == m_index.end()) {
+            _job.callback({});
+            return;
+        }
+        offset = it->second.offset;
+        size = it->second.size;
+    }
+
+    // Only this thread changes the data file, so the entry stays where it is while it's read
+    std::vector<char> data = BufferPool::GetInstance().acquire(size);
+    data.resize(size);
+
+    if (!m_dataFile || std::fseek(m_dataFile, offset, SEEK_SET) != 0 || std::fread(data.data(), 1, size, m_dataFile) != size) {
+        logMsg("ERROR: Cannot read %s from the tile cache\n", _job.url.c_str());
+        BufferPool::GetInstance().release(std::move(data));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            remove(_job.url);
+        }
+        _job.callback({});
+        return;
+    }
+
+    _job.callback(std::move(data));
+
+}
+
+void DiskCache::write(Job& _job) {
+
+    uint64_t offset = m_fileBytes;
+
+    if (!m_dataFile || std::fseek(m_dataFile, offset, SEEK_SET) != 0 ||
+        std::fwrite(_job.data.data(), 1, _job.data.size(), m_dataFile) != _job.data.size() ||
+        std::fflush(m_dataFile) != 0) {
+        logMsg("ERROR: Cannot write %s to the tile cache\n", _job.url.c_str());
+        return;
+    }
+
+    bool compactFile, writeIndex;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_fileBytes += _job.data.size();
+
+        remove(_job.url);
+
+        m_lru.push_back(_job.url);
+        m_index[_job.url] = { offset, (uint32_t)_job.data.size(), now(), std::prev(m_lru.end()) };
+        m_liveBytes += _job.data.size();
+
+        evict();
+
+        compactFile = m_fileBytes > 2 * m_maxBytes;
+        writeIndex = ++m_unsavedWrites >= s_indexSaveInterval;
+    }
+
+    // The files are written without the lock, so that the index can still be queried meanwhile
+    if (compactFile) {
+        compact();
+    } else if (writeIndex) {
+        saveIndex();
+    }
+
+}
+
+void DiskCache::evict() {
+
+    while (m_liveBytes > m_maxBytes && !m_lru.empty()) {
+        std::string url = m_lru.front();
+        remove(url);
+    }
+
+}
+
+void DiskCache::compact() {
+
+    struct Copy {
+        std::string url;
+        uint64_t offset;
+        uint32_t size;
+        bool copied;
+    };
+
+    // Entries are only added on this thread, so the snapshot holds every entry that can be in the index
+    // once the copy is done; entries removed meanwhile are skipped when the offsets are updated
+    std::vector<Copy> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entries.reserve(m_lru.size());
+        for (const auto& url : m_lru) {
+            const Entry& entry = m_index[url];
+            entries.push_back({ url, entry.offset, entry.size, false });
+        }
+    }
+
+    std::string tmpPath = m_dataPath + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "w+b");
+
+    if (!file) {
+        logMsg("ERROR: Cannot compact the tile cache in %s\n", tmpPath.c_str());
+        return;
+    }
+
+    std::vector<char> buffer;
+    uint64_t fileBytes = 0;
+
+    for (auto& entry : entries) {
+        buffer.resize(entry.size);
+
+        // Entries that can't be copied are dropped
+        entry.copied = std::fseek(m_dataFile, entry.offset, SEEK_SET) == 0 &&
+                       std::fread(buffer.data(), 1, entry.size, m_dataFile) == entry.size &&
+                       std::fwrite(buffer.data(), 1, entry.size, file) == entry.size;
+
+        if (entry.copied) {
+            entry.offset = fileBytes;
+            fileBytes += entry.size;
+        }
+    }
+
+    std::fclose(file);
+    std::fclose(m_dataFile);
+
+    if (std::rename(tmpPath.c_str(), m_dataPath.c_str()) != 0) {
+        logMsg("ERROR: Cannot replace the tile cache file %s\n", m_dataPath.c_str());
+        std::remove(tmpPath.c_str());
+        m_dataFile = std::fopen(m_dataPath.c_str(), "w+b");
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_index.clear();
+            m_lru.clear();
+            m_liveBytes = 0;
+            m_fileBytes = 0;
+        }
+        saveIndex();
+        return;
+    }
+
+    m_dataFile = std::fopen(m_dataPath.c_str(), "r+b");
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_fileBytes = fileBytes;
+
+        for (const auto& entry : entries) {
+            if (m_index.count(entry.url) == 0) {
+                continue;
+            }
+            if (entry.copied) {
+                m_index[entry.url].offset = entry.offset;
+            } else {
+                remove(entry.url);
+            }
+        }
+    }
+
+    saveIndex();
+
+}
+
+void DiskCache::remove(const std::string& _url) {
+
+    auto it = m_index.find(_url);
+
+    if (it != m_index.end()) {
+        m_liveBytes -= it->second.size;
+        m_lru.erase(it->second.lru);
+        m_index.erase(it);
+    }
+
+}
+
+bool DiskCache::isExpired(const Entry& _entry) const {
+
+    return m_maxAge > 0 && now() - _entry.stored > m_maxAge;
+
+}
+
+bool DiskCache::loadIndex() {
+
+    std::FILE* file = std::fopen(m_indexPath.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, count = 0;
+
+    bool valid = std::fread(magic, 1, 4, file) == 4 && std::memcmp(magic, s_indexMagic, 4) == 0 &&
+                 readValue(file, version) && version == s_indexVersion && readValue(file, count);
+
+    // Entries are stored least recently used first
+    for (uint32_t i = 0; valid && i < count; i++) {
+
+        uint32_t length;
+        std::string url;
+        Entry entry;
+
+        valid = readValue(file, length);
+        if (valid) {
+            url.resize(length);
+            valid = std::fread(&url[0], 1, length, file) == length &&
+                    readValue(file, entry.offset) && readValue(file, entry.size) && readValue(file, entry.stored);
+        }
+
+        if (valid && !isExpired(entry) && m_index.count(url) == 0) {
+            entry.lru = m_lru.insert(m_lru.end(), url);
+            m_index[url] = entry;
+            m_liveBytes += entry.size;
+        }
+    }
+
+    std::fclose(file);
+
+    if (!valid) {
+        logMsg("WARNING: Tile cache index %s is invalid, the cache is cleared\n", m_indexPath.c_str());
+    }
+
+    return valid;
+}
+
+bool DiskCache::saveIndex() {
+
+    struct Record {
+        std::string url;
+        Entry entry;
+    };
+
+    // Entries are stored least recently used first
+    std::vector<Record> records;
+    uint64_t snapshot;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_unsavedWrites = 0;
+        snapshot = ++m_indexSnapshot;
+
+        records.reserve(m_lru.size());
+        for (const auto& url : m_lru) {
+            records.push_back({ url, m_index[url] });
+        }
+    }
+
+    std::lock_guard<std::mutex> fileLock(m_indexFileMutex);
+
+    if (snapshot < m_savedSnapshot) {
+        // A newer snapshot was written while this one waited
+        return true;
+    }
+
+    // The index is replaced in one step, so that a crash leaves either the old or the new index
+    std::string tmpPath = m_indexPath + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        logMsg("ERROR: Cannot write tile cache index %s\n", tmpPath.c_str());
+        return false;
+    }
+
+    bool valid = std::fwrite(s_indexMagic, 1, 4, file) == 4 && writeValue(file, s_indexVersion) &&
+                 writeValue(file, (uint32_t)records.size());
+
+    for (auto it = records.begin(); valid && it != records.end(); ++it) {
+        const std::string& url = it->url;
+        const Entry& entry = it->entry;
+        valid = writeValue(file, (uint32_t)url.size()) && std::fwrite(url.data(), 1, url.size(), file) == url.size() &&
+                writeValue(file, entry.offset) && writeValue(file, entry.size) && writeValue(file, entry.stored);
+    }
+
+    valid = std::fclose(file) == 0 && valid;
+
+    if (!valid || std::rename(tmpPath.c_str(), m_indexPath.c_str()) != 0) {
+        logMsg("ERROR: Cannot write tile cache index %s\n", m_indexPath.c_str());
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    m_savedSnapshot = snapshot;
+
+    return true;
+}
+
+double DiskCache::now() {
+
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(system_clock::now().time_since_epoch()).count();
+
+}
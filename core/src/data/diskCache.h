@@ -0,0 +1,142 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "util/tileID.h"
+
+/* Persistent cache of raw tile data, keyed by URL
+ *
+ * Tile data is appended to a single data file; the position of each entry is kept in an index that is
+ * saved to a second file, in least-recently-used order, so that both the entries and their recency
+ * survive restarts. When the data of the live entries exceeds the size cap, the least recently used
+ * entries are dropped; entries older than the maximum age are treated as missing. The space of dropped
+ * entries is reclaimed by rewriting the data file once it is twice the size cap.
+ *
+ * Reads and writes of the files happen on a background I/O thread, without holding the lock of the index;
+ * the index is kept in memory and can be queried from any thread. Reads are made for an owner, e.g. a data
+ * source, and a tile, so that the reads of tiles sharing a URL are canceled separately.
+ */
+class DiskCache {
+
+public:
+
+    using Callback = std::function<void(std::vector<char>&&)>;
+
+    /* Creates a cache stored in the existing directory @_directory, holding at most @_maxBytes of tile
+     * data; entries older than @_maxAge seconds expire, 0 means that entries never expire */
+    DiskCache(const std::string& _directory, size_t _maxBytes, double _maxAge = 0);
+
+    /* Finishes pending writes and saves the index */
+    ~DiskCache();
+
+    /* Loads the index and opens the data file; returns false if the cache can't be used */
+    bool open();
+
+    /* Returns true if data for @_url is cached and has not expired */
+    bool contains(const std::string& _url);
+
+    /* Reads the data cached for @_url for the tile @_tileID of @_owner on the I/O thread and passes it to
+     * @_callback there, or passes empty data if the entry is gone or can't be read by then; returns false,
+     * without calling @_callback, if no data is cached for @_url */
+    bool get(const std::string& _url, const void* _owner, const TileID& _tileID, Callback _callback);
+
+    /* Adds a copy of @_data to the cache under @_url, replacing previous data */
+    void put(const std::string& _url, const std::vector<char>& _data);
+
+    /* Drops pending reads of @_url for the tile @_tileID of @_owner; a read in progress still calls its callback */
+    void cancel(const std::string& _url, const void* _owner, const TileID& _tileID);
+
+    /* Removes all entries; pending reads are called back with empty data */
+    void clear();
+
+    /* Blocks until all reads and writes queued so far are done */
+    void flush();
+
+    /* Returns the number of bytes of tile data of the live entries */
+    size_t getSize();
+
+    size_t getMaxBytes() const { return m_maxBytes; }
+
+private:
+
+    struct Entry {
+        uint64_t offset;
+        uint32_t size;
+        double stored; // Seconds since the epoch at which the data was written
+        std::list<std::string>::iterator lru;
+    };
+
+    struct Job {
+        std::string url;
+        std::vector<char> data; // Data to write; empty for reads
+        Callback callback;      // Called with the data read; empty for writes
+        const void* owner;      // Owner and tile of a read, see <cancel>; jobs are reassigned, so the
+        int x, y, z;            // coordinates of the tile are kept instead of a TileID
+    };
+
+    void run();
+
+    void read(Job& _job);
+    void write(Job& _job);
+
+    /* Drops least recently used entries until the live data fits the size cap; m_mutex must be held */
+    void evict();
+
+    /* Rewrites the data file with only the live entries, once dropped entries take up enough space;
+     * only called on the I/O thread, without m_mutex held: the entries are copied from a snapshot of the
+     * index and their offsets are updated under the lock once the new file is in place */
+    void compact();
+
+    /* Removes @_url from the index; m_mutex must be held */
+    void remove(const std::string& _url);
+
+    bool isExpired(const Entry& _entry) const;
+
+    bool loadIndex();
+
+    /* Writes a snapshot of the index to the index file; must be called without m_mutex held, since the
+     * file is written outside of it */
+    bool saveIndex();
+
+    static double now();
+
+    std::string m_dataPath;
+    std::string m_indexPath;
+
+    size_t m_maxBytes;
+    double m_maxAge;
+
+    std::mutex m_mutex; // Guards the index, m_jobs and the counters below
+    std::unordered_map<std::string, Entry> m_index;
+    std::list<std::string> m_lru; // URLs of the entries, least recently used first
+    size_t m_liveBytes = 0;
+    uint64_t m_fileBytes = 0; // Size of the data file, including dropped entries
+    int m_unsavedWrites = 0;
+    uint64_t m_indexSnapshot = 0; // Number of the latest snapshot of the index taken by <saveIndex>
+
+    std::deque<Job> m_jobs;
+    int m_busy = 0; // Number of jobs taken by the I/O thread and not finished
+    std::condition_variable m_condition;
+    std::condition_variable m_idle;
+    bool m_stop = false;
+
+    std::mutex m_indexFileMutex; // Guards writes of the index file and m_savedSnapshot
+    uint64_t m_savedSnapshot = 0; // Number of the snapshot last written to the index file
+
+    std::FILE* m_dataFile = nullptr; // Only used on the I/O thread once it is started
+    std::thread m_thread;
+
+    // Number of writes after which the index is saved, limiting the entries lost when the app is killed
+    static const int s_indexSaveInterval = 32;
+
+};
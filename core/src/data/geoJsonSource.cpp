@@ -1,4 +1,4 @@
-#include "geoJson.h"
+#include "geoJsonReader.h"
 #include "platform.h"
 #include "tileID.h"
 #include "labels/labelContainer.h"
@@ -14,36 +14,27 @@ GeoJsonSource::GeoJsonSource(const std::string& _name, const std::string& _urlTe
     DataSource(_name, _urlTemplate) {
 }
 
-std::shared_ptr<TileData> GeoJsonSource::parse(const MapTile& _tile, std::vector<char>& _rawData) const {
+std::shared_ptr<TileData> GeoJsonSource::parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const {
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
 
-    // parse written data into a JSON object
-    rapidjson::Document doc;
+    // Read features straight into the TileData, without building a JSON document of the tile
+    GeoJsonReader handler(*tileData, _tile, _cancel, "", m_clipBuffer);
+    rapidjson::Reader reader;
 
     rapidjson::MemoryStream ms(_rawData.data(), _rawData.size());
     rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> is(ms);
 
-    doc.ParseStream(is);
+    reader.Parse(is, handler);
 
-    if (doc.HasParseError()) {
+    if (reader.HasParseError() && !_cancel.isCanceled()) {
 
-        size_t offset = doc.GetErrorOffset();
-        const char* error = rapidjson::GetParseError_En(doc.GetParseError());
-        logMsg("Json parsing failed on tile [%d, %d, %d]: %s (%u)\n", _tile.getID().z, _tile.getID().x, _tile.getID().y, error, offset);
-        return tileData;
+        size_t offset = reader.GetErrorOffset();
+        const char* error = rapidjson::GetParseError_En(reader.GetParseErrorCode());
+        logMsg("Json parsing failed on tile [%d, %d, %d]: %s (%zu)\n", _tile.getID().z, _tile.getID().x, _tile.getID().y, error, offset);
 
     }
 
-    // transform JSON data into a TileData using GeoJson functions
-    for (auto layer = doc.MemberBegin(); layer != doc.MemberEnd(); ++layer) {
-        tileData->layers.emplace_back(std::string(layer->name.GetString()));
-        GeoJson::extractLayer(layer->value, tileData->layers.back(), _tile);
-    }
-
-
-    // Discard original JSON object and return TileData
-
     return tileData;
 
 }
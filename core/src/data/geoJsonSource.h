@@ -10,7 +10,7 @@ class GeoJsonSource: public DataSource {
     
 protected:
     
-    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData) const override;
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override;
     
 public:
     
@@ -12,13 +12,19 @@ MVTSource::MVTSource(const std::string& _name, const std::string& _urlTemplate)
     DataSource(_name, _urlTemplate) {
 }
 
-std::shared_ptr<TileData> MVTSource::parse(const MapTile& _tile, std::vector<char>& _rawData) const {
+std::shared_ptr<TileData> MVTSource::parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const {
+
+    return parseMvt(_tile, _rawData.data(), _rawData.size(), _cancel);
+
+}
+
+std::shared_ptr<TileData> MVTSource::parseMvt(const MapTile& _tile, const char* _data, size_t _size, const CancelToken& _cancel) const {
     
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
     
-    protobuf::message item(_rawData.data(), _rawData.size());
+    protobuf::message item(_data, _size);
 
-    while(item.next()) {
+    while(item.next() && !_cancel.isCanceled()) {
         if(item.tag == 3) {
             protobuf::message layerMsg = item.getMessage();
             protobuf::message layerItr = layerMsg;
@@ -26,7 +32,7 @@ std::shared_ptr<TileData> MVTSource::parse(const MapTile& _tile, std::vector<cha
                 if (layerItr.tag == 1) {
                     auto layerName = layerItr.string();
                     tileData->layers.emplace_back(layerName);
-                    PbfParser::extractLayer(layerMsg, tileData->layers.back(), _tile);
+                    PbfParser::extractLayer(layerMsg, tileData->layers.back(), _tile, _cancel, m_clipBuffer);
                 } else {
                     layerItr.skip();
                 }
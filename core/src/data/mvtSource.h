@@ -9,7 +9,10 @@ class MVTSource : public DataSource {
     
 protected:
     
-    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData) const override;
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override;
+
+    /* Parses the vector tile of @_size bytes at @_data, which is read in place */
+    std::shared_ptr<TileData> parseMvt(const MapTile& _tile, const char* _data, size_t _size, const CancelToken& _cancel) const;
     
 public:
     
@@ -0,0 +1,186 @@
+#include "requestCoalescer.h"
+#include "util/bufferPool.h"
+
+#include <algorithm>
+
+bool RequestCoalescer::request(const std::string& _url, const void* _owner, const TileID& _tileID, UrlCallback _callback, float _priority) {
+
+    unsigned long id;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it != m_requests.end()) {
+            // Already in flight, the data will be shared
+            it->second.subscribers.push_back({ _owner, _tileID, std::move(_callback), _priority });
+            if (updatePriority(it->second)) {
+                float priority = it->second.priority;
+                lock.unlock();
+                m_setPriority(_url, priority);
+            }
+            return true;
+        }
+
+        id = ++m_nextId;
+        Request& request = m_requests[_url];
+        request.id = id;
+        request.priority = _priority;
+        request.subscribers.push_back({ _owner, _tileID, std::move(_callback), _priority });
+    }
+
+    // Started outside of the lock, in case the platform runs the callback right away
+    bool started = m_start(_url, [this, _url, id](std::vector<char>&& _data) {
+        complete(_url, id, std::move(_data));
+    }, _priority);
+
+    if (!started) {
+        std::list<Subscriber> joined;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_requests.find(_url);
+            if (it != m_requests.end() && it->second.id == id) {
+                joined = std::move(it->second.subscribers);
+                m_requests.erase(it);
+            }
+        }
+        // The caller learns about the failure from the return value; tiles that joined in the meantime
+        // are told like for a failed request
+        if (!joined.empty()) {
+            joined.pop_front();
+        }
+        for (auto& subscriber : joined) {
+            subscriber.callback(std::vector<char>());
+        }
+    }
+
+    return started;
+}
+
+void RequestCoalescer::cancel(const std::string& _url, const void* _owner, const TileID& _tileID) {
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it == m_requests.end()) {
+            return;
+        }
+
+        auto& subscribers = it->second.subscribers;
+        size_t count = subscribers.size();
+
+        subscribers.remove_if([&](const Subscriber& _subscriber) {
+            return _subscriber.owner == _owner && _subscriber.tileID == _tileID;
+        });
+
+        if (subscribers.size() == count) {
+            return;
+        }
+
+        // Keep the request while other tiles wait for it, at the priority of the remaining tiles
+        if (!subscribers.empty()) {
+            if (updatePriority(it->second)) {
+                float priority = it->second.priority;
+                lock.unlock();
+                m_setPriority(_url, priority);
+            }
+            return;
+        }
+
+        m_requests.erase(it);
+    }
+
+    m_cancel(_url);
+
+}
+
+void RequestCoalescer::setPriority(const std::string& _url, const void* _owner, const TileID& _tileID, float _priority) {
+
+    float priority;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it == m_requests.end()) {
+            return;
+        }
+
+        for (auto& subscriber : it->second.subscribers) {
+            if (subscriber.owner == _owner && subscriber.tileID == _tileID) {
+                subscriber.priority = _priority;
+            }
+        }
+
+        if (!updatePriority(it->second)) {
+            return;
+        }
+
+        priority = it->second.priority;
+    }
+
+    m_setPriority(_url, priority);
+
+}
+
+bool RequestCoalescer::updatePriority(Request& _request) {
+
+    float priority = _request.subscribers.front().priority;
+    for (const auto& subscriber : _request.subscribers) {
+        priority = std::min(priority, subscriber.priority);
+    }
+
+    if (priority == _request.priority) {
+        return false;
+    }
+
+    _request.priority = priority;
+
+    return true;
+}
+
+size_t RequestCoalescer::getNumRequests() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_requests.size();
+}
+
+void RequestCoalescer::complete(const std::string& _url, unsigned long _id, std::vector<char>&& _data) {
+
+    std::list<Subscriber> subscribers;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it == m_requests.end() || it->second.id != _id) {
+            // The request was canceled after it started
+            return;
+        }
+
+        subscribers = std::move(it->second.subscribers);
+        m_requests.erase(it);
+    }
+
+    if (_data.empty()) {
+        // The request failed; the entry is gone, so subscribers can request the URL again
+        for (auto& subscriber : subscribers) {
+            subscriber.callback(std::vector<char>());
+        }
+        return;
+    }
+
+    // Every subscriber but the last gets a copy of the data
+    for (auto it = subscribers.begin(); it != subscribers.end(); ++it) {
+        if (std::next(it) == subscribers.end()) {
+            it->callback(std::move(_data));
+        } else {
+            std::vector<char> copy = BufferPool::GetInstance().acquire(_data.size());
+            copy.assign(_data.begin(), _data.end());
+            it->callback(std::move(copy));
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "platform.h"
+#include "util/tileID.h"
+
+/* Shares URL requests between all tiles and data sources that need the same URL
+ *
+ * A request for a URL that is already in flight adds its callback to that request instead of starting a
+ * new one; all callbacks receive the data once it arrives. Callbacks are registered for an owner, e.g. a
+ * data source, and a tile, so that canceling the request of one tile keeps the request alive for the
+ * others; the platform request is only canceled once no callbacks remain.
+ *
+ * A request that fails calls all of its callbacks with empty data and is forgotten, so that the next
+ * request for the URL starts over.
+ */
+class RequestCoalescer {
+
+public:
+
+    using StartRequest = std::function<bool(const std::string&, UrlCallback, float)>;
+    using CancelRequest = std::function<void(const std::string&)>;
+    using SetRequestPriority = std::function<void(const std::string&, float)>;
+
+    static RequestCoalescer& GetInstance() {
+        static RequestCoalescer instance;
+        return instance;
+    }
+
+    /* Creates a coalescer that issues requests with the given functions instead of the platform ones,
+     * e.g. for tests; use <GetInstance> to share requests across the whole map */
+    RequestCoalescer(StartRequest _start, CancelRequest _cancel, SetRequestPriority _setPriority) :
+        m_start(_start), m_cancel(_cancel), m_setPriority(_setPriority) {}
+
+    /* Requests @_url for the tile @_tileID of @_owner with the priority @_priority, calling @_callback with
+     * the data when it arrives; returns false if a new request could not be started */
+    bool request(const std::string& _url, const void* _owner, const TileID& _tileID, UrlCallback _callback, float _priority = 0);
+
+    /* Sets the priority of the callbacks of @_owner for @_tileID; a request is served with the most urgent
+     * priority of its callbacks */
+    void setPriority(const std::string& _url, const void* _owner, const TileID& _tileID, float _priority);
+
+    /* Removes the callbacks of @_owner for @_tileID from the request for @_url, canceling the request if
+     * no other callbacks remain */
+    void cancel(const std::string& _url, const void* _owner, const TileID& _tileID);
+
+    /* Returns the number of URLs currently requested */
+    size_t getNumRequests();
+
+private:
+
+    RequestCoalescer() : m_start(startUrlRequest), m_cancel(cancelUrlRequest), m_setPriority(setUrlRequestPriority) {}
+
+    struct Subscriber {
+        const void* owner;
+        TileID tileID;
+        UrlCallback callback;
+        float priority;
+    };
+
+    struct Request {
+        unsigned long id; // Distinguishes a new request for a URL from a canceled one that still completes
+        std::list<Subscriber> subscribers;
+        float priority; // Priority of the platform request
+    };
+
+    /* Updates the priority of @_request to the most urgent priority of its subscribers; returns true if it changed */
+    static bool updatePriority(Request& _request);
+
+    void complete(const std::string& _url, unsigned long _id, std::vector<char>&& _data);
+
+    StartRequest m_start;
+    CancelRequest m_cancel;
+    SetRequestPriority m_setPriority;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Request> m_requests;
+    unsigned long m_nextId = 0;
+
+};
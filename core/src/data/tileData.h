@@ -4,6 +4,7 @@
 #include <string>
 #include <unordered_map>
 #include "glm/vec3.hpp"
+#include "util/memoryTracker.h"
 
 /* Notes on TileData implementation:
 
@@ -67,6 +68,12 @@ struct Properties {
     
     std::unordered_map<std::string, std::string> stringProps;
     std::unordered_map<std::string, float> numericProps;
+
+    /* Returns the numeric property @_key, or @_default if it is not present */
+    float getNumeric(const std::string& _key, float _default = 0.f) const {
+        auto it = numericProps.find(_key);
+        return it != numericProps.end() ? it->second : _default;
+    }
     
 };
 
@@ -95,6 +102,49 @@ struct Layer {
 struct TileData {
     
     std::vector<Layer> layers;
+
+    // Reports the memory used by this data while it exists; set with <getMemoryUsage> once the data is complete
+    TrackedMemory memory;
+
+    TileData() : memory(MemoryCategory::tileData) {}
+
+    /* Returns an estimate of the heap memory used by the layers of this data, in bytes */
+    size_t getMemoryUsage() const {
+
+        // Approximate cost of one node in an unordered_map, excluding its key and value
+        const size_t nodeSize = 2 * sizeof(void*);
+
+        size_t bytes = layers.capacity() * sizeof(Layer);
+
+        for (const auto& layer : layers) {
+            bytes += layer.name.capacity() + layer.features.capacity() * sizeof(Feature);
+
+            for (const auto& feature : layer.features) {
+                bytes += feature.points.capacity() * sizeof(Point);
+                bytes += feature.lines.capacity() * sizeof(Line);
+                bytes += feature.polygons.capacity() * sizeof(Polygon);
+
+                for (const auto& line : feature.lines) {
+                    bytes += line.capacity() * sizeof(Point);
+                }
+                for (const auto& polygon : feature.polygons) {
+                    bytes += polygon.capacity() * sizeof(Line);
+                    for (const auto& ring : polygon) {
+                        bytes += ring.capacity() * sizeof(Point);
+                    }
+                }
+
+                for (const auto& prop : feature.props.stringProps) {
+                    bytes += nodeSize + sizeof(prop) + prop.first.capacity() + prop.second.capacity();
+                }
+                for (const auto& prop : feature.props.numericProps) {
+                    bytes += nodeSize + sizeof(prop) + prop.first.capacity();
+                }
+            }
+        }
+
+        return bytes;
+    }
     
 };
 
@@ -0,0 +1,64 @@
+#include "topoJson.h"
+#include "platform.h"
+#include "tileID.h"
+
+#include "topoJsonSource.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/encodings.h"
+#include "rapidjson/encodedstream.h"
+
+
+TopoJsonSource::TopoJsonSource(const std::string& _name, const std::string& _urlTemplate) :
+    DataSource(_name, _urlTemplate) {
+}
+
+std::shared_ptr<TileData> TopoJsonSource::parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const {
+
+    std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
+
+    // parse written data into a JSON object
+    rapidjson::Document doc;
+
+    rapidjson::MemoryStream ms(_rawData.data(), _rawData.size());
+    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> is(ms);
+
+    doc.ParseStream(is);
+
+    if (doc.HasParseError()) {
+
+        size_t offset = doc.GetErrorOffset();
+        const char* error = rapidjson::GetParseError_En(doc.GetParseError());
+        logMsg("Json parsing failed on tile [%d, %d, %d]: %s (%zu)\n", _tile.getID().z, _tile.getID().x, _tile.getID().y, error, offset);
+        return tileData;
+
+    }
+
+    if (!doc.IsObject()) {
+        logMsg("ERROR: TopoJSON tile [%d, %d, %d] is not an object\n", _tile.getID().z, _tile.getID().x, _tile.getID().y);
+        return tileData;
+    }
+
+    auto objects = doc.FindMember("objects");
+
+    if (objects == doc.MemberEnd() || !objects->value.IsObject()) {
+        logMsg("ERROR: TopoJSON tile [%d, %d, %d] has no 'objects' member\n", _tile.getID().z, _tile.getID().x, _tile.getID().y);
+        return tileData;
+    }
+
+    // Decode the arcs shared by all layers once
+    TopoJson::Topology topology;
+    TopoJson::extractTopology(doc, topology, _tile);
+
+    // transform TopoJSON objects into a TileData layer each
+    for (auto layer = objects->value.MemberBegin(); layer != objects->value.MemberEnd(); ++layer) {
+        if (_cancel.isCanceled()) {
+            break;
+        }
+        tileData->layers.emplace_back(std::string(layer->name.GetString()));
+        TopoJson::extractLayer(layer->value, tileData->layers.back(), topology, _tile, _cancel, m_clipBuffer);
+    }
+
+    return tileData;
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "dataSource.h"
+#include "mapTile.h"
+#include "tileData.h"
+
+
+/* Extends DataSource class to read TopoJSON vector tiles, with one object per layer */
+class TopoJsonSource: public DataSource {
+    
+protected:
+    
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override;
+    
+public:
+    
+    TopoJsonSource(const std::string& _name, const std::string& _urlTemplate);
+    
+};
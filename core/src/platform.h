@@ -30,7 +30,11 @@ void NSurlInit();
 #endif
 
 #if (defined PLATFORM_LINUX) || (defined PLATFORM_RPI)
+/* Calls the callbacks of URL requests that finished since the last call */
 void processNetworkQueue();
+
+/* Aborts all URL requests and stops the network thread; call before curl_global_cleanup */
+void finishUrlRequests();
 #endif
 
 /* Print a formatted message to the console
@@ -68,15 +72,23 @@ std::string stringFromResource(const char* _path);
  */ 
 unsigned char* bytesFromResource(const char* _path, unsigned int* _size);
 
-/* Function type for receiving data from a successful network request */
+/* Function type for receiving data from a network request; the data is empty if the request failed */
 using UrlCallback = std::function<void(std::vector<char>&&)>;
 
 /* Start retrieving data from a URL asynchronously
  * 
  * When the request is finished, the callback @_callback will be
- * run with the data that was retrieved from the URL @_url
+ * run with the data that was retrieved from the URL @_url, or with
+ * empty data if the request failed; requests with lower values of
+ * @_priority are served first. The callback of a canceled request
+ * may or may not be run
+ */
+bool startUrlRequest(const std::string& _url, UrlCallback _callback, float _priority = 0);
+
+/* Change the priority of a URL request that was previously started,
+ * e.g. when the view moved; has no effect once the request is running
  */
-bool startUrlRequest(const std::string& _url, UrlCallback _callback);
+void setUrlRequestPriority(const std::string& _url, float _priority);
 
 /* Stop retrieving data from a URL that was previously requested
  */
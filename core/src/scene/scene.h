@@ -23,6 +23,7 @@ public:
     void addLight(std::unique_ptr<Light> _light);
 
     std::vector<std::unique_ptr<Style>>& getStyles() { return m_styles; };
+    const std::vector<std::unique_ptr<Style>>& getStyles() const { return m_styles; };
     
     /*  Get all Lights */
     std::map<std::string, std::unique_ptr<Light>>& getLights(){ return m_lights; };
@@ -8,7 +8,10 @@
 #include "view.h"
 #include "lights.h"
 #include "geoJsonSource.h"
+#include "clientGeoJsonSource.h"
+#include "topoJsonSource.h"
 #include "mvtSource.h"
+#include "archiveSource.h"
 #include "polygonStyle.h"
 #include "polylineStyle.h"
 #include "debugStyle.h"
@@ -84,13 +87,30 @@ void SceneLoader::loadSources(Node sources, TileManager& tileManager) {
 
         if (type == "GeoJSONTiles") {
             sourcePtr = std::unique_ptr<DataSource>(new GeoJsonSource(name, url));
+        } else if (type == "GeoJSON") {
+            // A single file, tiled on the client; the url is a file path or URL
+            sourcePtr = std::unique_ptr<DataSource>(new ClientGeoJsonSource(name, url));
         } else if (type == "TopoJSONTiles") {
-            // TODO
+            sourcePtr = std::unique_ptr<DataSource>(new TopoJsonSource(name, url));
         } else if (type == "MVT") {
             sourcePtr = std::unique_ptr<DataSource>(new MVTSource(name, url));
+        } else if (type == "TileArchive") {
+            // The url is the path of the archive file
+            sourcePtr = std::unique_ptr<DataSource>(new ArchiveSource(name, url));
         }
 
         if (sourcePtr) {
+            if (source["max_zoom"]) {
+                sourcePtr->setMaxZoom(source["max_zoom"].as<int>());
+            }
+            if (source["clip_buffer"]) {
+                // Fraction of the tile size around tiles to which geometry is clipped
+                sourcePtr->setClipBuffer(source["clip_buffer"].as<float>());
+            }
+            if (source["simplify_tolerance"]) {
+                // Tolerance in pixels of the simplification of lines and polygons, 0 to disable it
+                sourcePtr->setSimplifyTolerance(source["simplify_tolerance"].as<float>());
+            }
             tileManager.addDataSource(std::move(sourcePtr));
         }
     }
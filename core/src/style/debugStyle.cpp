@@ -36,7 +36,7 @@ void* DebugStyle::parseStyleParams(const std::string& _layerNameID, const StyleP
     return nullptr;
 }
 
-void DebugStyle::addData(TileData &_data, MapTile &_tile, const MapProjection &_mapProjection) {
+void DebugStyle::addData(const TileData& _data, MapTile &_tile, const MapProjection &_mapProjection, const CancelToken& _cancel) {
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::TILE_BOUNDS)) {
 
@@ -63,19 +63,19 @@ void DebugStyle::addData(TileData &_data, MapTile &_tile, const MapProjection &_
 
 }
 
-void DebugStyle::buildPoint(Point &_point, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildPoint(const Point& _point, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
     // No-op
 
 }
 
-void DebugStyle::buildLine(Line &_line, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildLine(const Line& _line, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
     // No-op
 
 }
 
-void DebugStyle::buildPolygon(Polygon &_polygon, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildPolygon(const Polygon& _polygon, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
     // No-op
 
@@ -16,10 +16,10 @@ protected:
 
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) override;
+    virtual void buildPoint(const Point& _point, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildLine(const Line& _line, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildPolygon(const Polygon& _polygon, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel) override;
 
     virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) override;
 
@@ -7,7 +7,7 @@ DebugTextStyle::DebugTextStyle(const std::string& _fontName, std::string _name,
 
 }
 
-void DebugTextStyle::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void DebugTextStyle::addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel) {
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::TILE_INFOS)) {
         onBeginBuildTile(_tile);
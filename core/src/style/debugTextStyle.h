@@ -14,7 +14,7 @@ protected:
         float fsID;
     };
 
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) override;
+    virtual void addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel) override;
 
     typedef TypedMesh<PosTexID> Mesh;
 
@@ -52,11 +52,23 @@ void* PolygonStyle::parseStyleParams(const std::string& _layerNameID, const Styl
     return static_cast<void*>(params);
 }
 
-void PolygonStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolygonStyle::invalidateStyleParams(const std::string& _layerNameID) {
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+    auto it = m_styleParamCache.find(_layerNameID);
+    if (it != m_styleParamCache.end()) {
+        m_invalidParams.push_back(it->second);
+        m_styleParamCache.erase(it);
+    }
+
+}
+
+void PolygonStyle::buildPoint(const Point& _point, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     // No-op
 }
 
-void PolygonStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolygonStyle::buildLine(const Line& _line, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     std::vector<PosNormColVertex> vertices;
     std::vector<int> indices;
     std::vector<glm::vec3> points;
@@ -76,7 +88,7 @@ void PolygonStyle::buildLine(Line& _line, void* _styleParam, Properties& _props,
     mesh.addVertices(std::move(vertices),std::move(indices));
 }
 
-void PolygonStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolygonStyle::buildPolygon(const Polygon& _polygon, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
     std::vector<PosNormColVertex> vertices;
     std::vector<int> indices;
@@ -92,23 +104,26 @@ void PolygonStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties
     GLfloat layer = params->order;
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::PROXY_COLORS)) {
-        abgr = abgr << (int(_props.numericProps["zoom"]) % 6);
+        abgr = abgr << (_tile.getID().z % 6);
     }
 
-    float height = _props.numericProps["height"]; // Inits to zero if not present in data
-    float minHeight = _props.numericProps["min_height"]; // Inits to zero if not present in data
+    float height = _props.getNumeric("height"); // Zero if not present in data
+    float minHeight = _props.getNumeric("min_height"); // Zero if not present in data
 
     if (minHeight != height) {
-        for (auto& line : _polygon) {
+        // The shared tile data is not modified, extruded polygons are raised on a copy
+        Polygon raised = _polygon;
+        for (auto& line : raised) {
             for (auto& point : line) {
                 point.z = height;
             }
         }
-        Builders::buildPolygonExtrusion(_polygon, minHeight, output);
+        Builders::buildPolygonExtrusion(raised, minHeight, output);
+        Builders::buildPolygon(raised, output);
+    } else {
+        Builders::buildPolygon(_polygon, output);
     }
 
-    Builders::buildPolygon(_polygon, output);
-
     for (size_t i = 0; i < points.size(); i++) {
         vertices.push_back({ points[i], normals[i], texcoords[i], abgr, layer });
     }
@@ -98,11 +98,23 @@ void* PolylineStyle::parseStyleParams(const std::string& _layerNameID, const Sty
     return static_cast<void*>(params);
 }
 
-void PolylineStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolylineStyle::invalidateStyleParams(const std::string& _layerNameID) {
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+    auto it = m_styleParamCache.find(_layerNameID);
+    if (it != m_styleParamCache.end()) {
+        m_invalidParams.push_back(it->second);
+        m_styleParamCache.erase(it);
+    }
+
+}
+
+void PolylineStyle::buildPoint(const Point& _point, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     // No-op
 }
 
-void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolylineStyle::buildLine(const Line& _line, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     std::vector<PosNormEnormColVertex> vertices;
     std::vector<int> indices;
     std::vector<glm::vec3> points;
@@ -113,10 +125,10 @@ void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props
     GLuint abgr = params->color;
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::PROXY_COLORS)) {
-        abgr = abgr << (int(_props.numericProps["zoom"]) % 6);
+        abgr = abgr << (_tile.getID().z % 6);
     }
 
-    GLfloat layer = _props.numericProps["sort_key"] + params->order;
+    GLfloat layer = _props.getNumeric("sort_key") + params->order;
 
     float halfWidth = params->width * .5f;
 
@@ -172,6 +184,6 @@ void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props
     mesh.addVertices(std::move(vertices), std::move(indices));
 }
 
-void PolylineStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolylineStyle::buildPolygon(const Polygon& _polygon, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     // No-op
 }
@@ -38,10 +38,11 @@ protected:
 
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
+    virtual void buildPoint(const Point& _point, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildLine(const Line& _line, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildPolygon(const Polygon& _polygon, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
     virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) override;
+    virtual void invalidateStyleParams(const std::string& _layerNameID) override;
 
     typedef TypedMesh<PosNormEnormColVertex> Mesh;
 
@@ -50,6 +51,7 @@ protected:
     };
 
     std::unordered_map<std::string, StyleParams*> m_styleParamCache;
+    std::vector<StyleParams*> m_invalidParams; // Replaced parameters, deleted with the style since tiles being built may use them
     std::mutex m_cacheMutex;
 
 public:
@@ -62,5 +64,8 @@ public:
             delete styleParam.second;
         }
         m_styleParamCache.clear();
+        for(auto* styleParam : m_invalidParams) {
+            delete styleParam;
+        }
     }
 };
@@ -38,15 +38,15 @@ void* SpriteStyle::parseStyleParams(const std::string& _layerNameID, const Style
     return nullptr;
 }
 
-void SpriteStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildPoint(const Point& _point, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
 }
 
-void SpriteStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildLine(const Line& _line, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
 }
 
-void SpriteStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildPolygon(const Polygon& _polygon, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
 }
 
@@ -56,7 +56,7 @@ void SpriteStyle::onBeginDrawFrame(const std::shared_ptr<View>& _view, const std
     m_shaderProgram->setUniformi("u_tex", 0);
 }
 
-void SpriteStyle::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void SpriteStyle::addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel) {
 
     Mesh* mesh = new Mesh(m_vertexLayout, m_drawMode);
 
@@ -39,24 +39,61 @@ void Style::setMaterial(const std::shared_ptr<Material>& _material) {
 
 void Style::addLayer(const std::pair<std::string, StyleParamMap>&& _layer) {
 
+    std::lock_guard<std::mutex> lock(m_layersMutex);
     m_layers.push_back(std::move(_layer));
 
 }
 
-void Style::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void Style::updateLayer(const std::string& _layerName, const StyleParamMap& _params) {
+
+    std::lock_guard<std::mutex> lock(m_layersMutex);
+
+    auto it = m_layers.begin();
+    while (it != m_layers.end() && it->first != _layerName) {
+        ++it;
+    }
+
+    if (it == m_layers.end()) {
+        m_layers.emplace_back(_layerName, _params);
+    } else {
+        it->second = _params;
+    }
+
+    invalidateStyleParams(_layerName);
+
+}
+
+void Style::addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel) {
     onBeginBuildTile(_tile);
 
     VboMesh* mesh = newMesh();
 
-    for (auto& layer : _data.layers) {
+    for (const auto& layer : _data.layers) {
+
+        if (_cancel.isCanceled()) {
+            break;
+        }
 
-        // Skip any layers that this style doesn't have a rule for
-        auto it = m_layers.begin();
-        while (it != m_layers.end() && it->first != layer.name) { ++it; }
-        if (it == m_layers.end()) { continue; }
+        // Parameters are resolved once per layer, since the layer rules may be updated concurrently
+        void* styleParams = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_layersMutex);
+
+            // Skip any layers that this style doesn't have a rule for
+            auto it = m_layers.begin();
+            while (it != m_layers.end() && it->first != layer.name) { ++it; }
+            if (it == m_layers.end()) { continue; }
+
+            styleParams = parseStyleParams(it->first, it->second);
+        }
 
         // Loop over all features
-        for (auto& feature : layer.features) {
+        size_t featureIndex = 0;
+        for (const auto& feature : layer.features) {
+
+            if (_cancel.isCanceled(++featureIndex)) {
+                break;
+            }
 
             /*
              * TODO: do filter evaluation for each feature for sublayer!
@@ -65,25 +102,23 @@ void Style::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapPr
              *     NOTE: for the time being use layerName as ID for cache
              */
 
-            feature.props.numericProps["zoom"] = _tile.getID().z;
-
             switch (feature.geometryType) {
                 case GeometryType::POINTS:
                     // Build points
-                    for (auto& point : feature.points) {
-                        buildPoint(point, parseStyleParams(it->first, it->second), feature.props, *mesh);
+                    for (const auto& point : feature.points) {
+                        buildPoint(point, styleParams, feature.props, *mesh, _tile);
                     }
                     break;
                 case GeometryType::LINES:
                     // Build lines
-                    for (auto& line : feature.lines) {
-                        buildLine(line, parseStyleParams(it->first, it->second), feature.props, *mesh);
+                    for (const auto& line : feature.lines) {
+                        buildLine(line, styleParams, feature.props, *mesh, _tile);
                     }
                     break;
                 case GeometryType::POLYGONS:
                     // Build polygons
-                    for (auto& polygon : feature.polygons) {
-                        buildPolygon(polygon, parseStyleParams(it->first, it->second), feature.props, *mesh);
+                    for (const auto& polygon : feature.polygons) {
+                        buildPolygon(polygon, styleParams, feature.props, *mesh, _tile);
                     }
                     break;
                 default:
@@ -92,10 +127,12 @@ void Style::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapPr
         }
     }
 
-    if (mesh->numVertices() == 0) {
+    if (mesh->numVertices() == 0 || _cancel.isCanceled()) {
         delete mesh;
     } else {
+        double start = TileTiming::now();
         mesh->compileVertexBuffer();
+        _tile.getTiming().compileTime += TileTiming::now() - start;
 
         _tile.addGeometry(*this, std::unique_ptr<VboMesh>(mesh));
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,7 @@
 #include "util/shaderProgram.h"
 #include "util/mapProjection.h"
 #include "util/builders.h"
+#include "util/cancelToken.h"
 #include "view/view.h"
 #include "styleParamMap.h"
 #include "csscolorparser.hpp"
@@ -62,25 +64,34 @@ protected:
      * to be parsed explicitly by styles for their style parameters*/
     std::vector< std::pair<std::string, StyleParamMap> > m_layers;
 
+    /* Guards m_layers, which can be updated while tiles are being built */
+    std::mutex m_layersMutex;
+
     /* Create <VertexLayout> corresponding to this style; subclasses must implement this and call it on construction */
     virtual void constructVertexLayout() = 0;
 
     /* Create <ShaderProgram> for this style; subclasses must implement this and call it on construction */
     virtual void constructShaderProgram() = 0;
 
-    /* Build styled vertex data for point geometry and add it to the given <VboMesh> */
-    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    /* Build styled vertex data for point geometry and add it to the given <VboMesh>; @_tile is the tile being built,
+     * which may be built by other styles at the same time, so only data of this style may be added to it.
+     * Geometry and properties are shared with other styles and must not be modified */
+    virtual void buildPoint(const Point& _point, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const = 0;
 
     /* Build styled vertex data for line geometry and add it to the given <VboMesh> */
-    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    virtual void buildLine(const Line& _line, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const = 0;
 
     /* Build styled vertex data for polygon geometry and add it to the given <VboMesh> */
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    virtual void buildPolygon(const Polygon& _polygon, void* _styleParam, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const = 0;
 
     /* Parse StyleParamMap to apt Style property parameters, and puts in the styleParamCache
      * NOTE: layerNameID will be replaced by unique ID for a set of filter matches*/
     virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) = 0;
 
+    /* Discards the cached result of <parseStyleParams> for @_layerNameID, so that it is parsed again;
+     * parameters may still be in use by tiles being built and must stay valid */
+    virtual void invalidateStyleParams(const std::string& _layerNameID) {}
+
     /* parse color properties */
     static uint32_t parseColorProp(const std::string& _colorPropStr) ;
 
@@ -102,8 +113,17 @@ public:
     /* Add layers to which this style will apply */
     virtual void addLayer(const std::pair<std::string, StyleParamMap>&& _layer);
 
-    /* Add styled geometry from the given <TileData> object to the given <MapTile> */
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection);
+    /* Replaces the style parameters of the layer @_layerName, adding the layer if this style has no rule for it;
+     * tiles built from then on use the new parameters, tiles already built must be restyled (see TileManager::restyle) */
+    void updateLayer(const std::string& _layerName, const StyleParamMap& _params);
+
+    /* Add styled geometry from the given <TileData> object to the given <MapTile>
+     *
+     * Stops without adding any geometry once @_cancel is canceled; it is polled for each layer
+     * and for each batch of features. @_data is only read, so that several styles can build the
+     * same data concurrently
+     */
+    virtual void addData(const TileData& _data, MapTile& _tile, const MapProjection& _mapProjection, const CancelToken& _cancel);
 
     /* Perform any setup needed before drawing each frame */
     virtual void onBeginDrawFrame(const std::shared_ptr<View>& _view, const std::shared_ptr<Scene>& _scene);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <unordered_map>
 
 typedef std::unordered_map<std::string, std::string> StyleParamMap;
@@ -1,7 +1,6 @@
 #include "textStyle.h"
 #include "text/fontContext.h"
 
-MapTile* TextStyle::s_processedTile = nullptr;
 
 TextStyle::TextStyle(const std::string& _fontName, std::string _name, float _fontSize, unsigned int _color, bool _sdf, bool _sdfMultisampling, GLenum _drawMode)
 : Style(_name, _drawMode), m_fontName(_fontName), m_fontSize(_fontSize), m_color(_color), m_sdf(_sdf), m_sdfMultisampling(_sdfMultisampling)  {
@@ -43,7 +42,7 @@ void* TextStyle::parseStyleParams(const std::string& _layerNameID, const StylePa
     return nullptr;
 }
 
-void TextStyle::buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildPoint(const Point& _point, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     std::vector<PosTexID> vertices;
     auto labelContainer = LabelContainer::GetInstance();
     auto ftContext = labelContainer->getFontContext();
@@ -63,7 +62,7 @@ void TextStyle::buildPoint(Point& _point, void* _styleParams, Properties& _props
     // if (_layer == "pois") {
     //     for (auto prop : _props.stringProps) {
     //         if (prop.first == "name") {
-    //             labelContainer->addLabel(*TextStyle::s_processedTile, m_name, { glm::vec2(_point), glm::vec2(_point) }, prop.second, Label::Type::POINT);
+    //             labelContainer->addLabel(_tile, m_name, { glm::vec2(_point), glm::vec2(_point) }, prop.second, Label::Type::POINT);
     //         }
     //     }
     // }
@@ -79,7 +78,7 @@ void TextStyle::buildPoint(Point& _point, void* _styleParams, Properties& _props
 
 }
 
-void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildLine(const Line& _line, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
     std::vector<PosTexID> vertices;
     auto labelContainer = LabelContainer::GetInstance();
     auto ftContext = labelContainer->getFontContext();
@@ -115,7 +114,7 @@ void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, V
     //                     continue;
     //                 }
 
-    //                 labelContainer->addLabel(*TextStyle::s_processedTile, m_name, { p1, p2 }, prop.second,
+    //                 labelContainer->addLabel(_tile, m_name, { p1, p2 }, prop.second,
     //                                          Label::Type::LINE);
     //             }
     //         }
@@ -132,7 +131,7 @@ void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, V
     }
 }
 
-void TextStyle::buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildPolygon(const Polygon& _polygon, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const {
 
     glm::vec3 centroid;
     int n = 0;
@@ -165,7 +164,7 @@ void TextStyle::buildPolygon(Polygon& _polygon, void* _styleParams, Properties&
 
     for (auto& prop : _props.stringProps) {
         if (prop.first == "name") {
-            labelContainer->addLabel(*TextStyle::s_processedTile, m_name, { glm::vec2(centroid), glm::vec2(centroid) }, prop.second, Label::Type::POINT);
+            labelContainer->addLabel(_tile, m_name, { glm::vec2(centroid), glm::vec2(centroid) }, prop.second, Label::Type::POINT);
         }
     }
 
@@ -189,15 +188,11 @@ void TextStyle::onBeginBuildTile(MapTile& _tile) const {
     ftContext->useBuffer(buffer);
 
     buffer->init();
-
-    TextStyle::s_processedTile = &_tile;
 }
 
 void TextStyle::onEndBuildTile(MapTile& _tile) const {
     auto ftContext = LabelContainer::GetInstance()->getFontContext();
 
-    TextStyle::s_processedTile = nullptr;
-
     ftContext->useBuffer(nullptr);
     ftContext->unlock();
 }
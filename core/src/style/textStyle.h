@@ -20,9 +20,9 @@ protected:
 
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
+    virtual void buildPoint(const Point& _point, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildLine(const Line& _line, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
+    virtual void buildPolygon(const Polygon& _polygon, void* _styleParams, const Properties& _props, VboMesh& _mesh, MapTile& _tile) const override;
     virtual void onBeginBuildTile(MapTile& _tile) const override;
     virtual void onEndBuildTile(MapTile& _tile) const override;
 
@@ -51,10 +51,4 @@ public:
 
     virtual ~TextStyle();
 
-    /*
-     * A pointer to the tile being currently processed, e.g. the tile which data is being added to
-     * nullptr if no tile is being processed
-     */
-    static MapTile* s_processedTile;
-
 };
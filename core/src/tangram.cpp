@@ -9,6 +9,7 @@
 #include "scene/scene.h"
 #include "scene/sceneLoader.h"
 #include "stl_util.hpp"
+#include "data/diskCache.h"
 #include "style/debugStyle.h"
 #include "style/debugTextStyle.h"
 #include "style/spriteStyle.h"
@@ -16,6 +17,7 @@
 #include "text/fontContext.h"
 #include "tile/tileManager.h"
 #include "util/error.h"
+#include "util/memoryTracker.h"
 #include "util/skybox.h"
 #include "util/tileID.h"
 #include "view/view.h"
@@ -32,6 +34,13 @@ namespace Tangram {
 
     static float g_time = 0.0;
     static unsigned long g_flags = 0;
+    static int g_numTileWorkers = 0; // 0 uses the default thread count of the TileManager
+    static size_t g_tileCacheSize = TileCache::s_defaultCacheSize;
+    static size_t g_tileDataBudget = DataSource::s_defaultStoreBudget;
+    static float g_prefetchTime = 0.3f;
+    static PrefetchMode g_prefetchMode = PrefetchMode::build;
+    static size_t g_uploadBudget = UploadScheduler::s_defaultBudget;
+    static std::shared_ptr<DiskCache> g_diskCache;
 
     void initialize() {
 
@@ -40,6 +49,7 @@ namespace Tangram {
         // Create view
         if (!m_view) {
             m_view = std::make_shared<View>();
+            m_view->setPrefetchTime(g_prefetchTime);
         }
 
         // Create a scene object
@@ -57,6 +67,16 @@ namespace Tangram {
             // Pass references to the view and scene into the tile manager
             m_tileManager->setView(m_view);
             m_tileManager->setScene(m_scene);
+
+            if (g_numTileWorkers > 0) {
+                m_tileManager->setNumWorkers(g_numTileWorkers);
+            }
+
+            m_tileManager->setCacheSize(g_tileCacheSize);
+            m_tileManager->setTileDataBudget(g_tileDataBudget);
+            m_tileManager->setUploadBudget(g_uploadBudget);
+            m_tileManager->setDiskCache(g_diskCache);
+            m_tileManager->setPrefetchMode(g_prefetchTime > 0 ? g_prefetchMode : PrefetchMode::none);
         }
 
         SceneLoader loader;
@@ -128,10 +148,12 @@ namespace Tangram {
 
         if (m_view) {
 
-            m_view->update();
+            m_view->update(_dt);
 
             m_tileManager->updateTileSet();
 
+            MemoryTracker::GetInstance().enforceBudget();
+
             if(m_view->changedOnLastUpdate() || m_tileManager->hasTileSetChanged() || Label::s_needUpdate) {
                 Label::s_needUpdate = false;
 
@@ -159,7 +181,8 @@ namespace Tangram {
                 }
             }
 
-            if (Label::s_needUpdate) {
+            if (Label::s_needUpdate || m_tileManager->getPendingUploadBytes() > 0) {
+                // Meshes left over the upload budget are uploaded in the next frames
                 requestRender();
             }
         }
@@ -181,7 +204,7 @@ namespace Tangram {
             // Loop over all tiles in m_tileSet
             for (const auto& mapIDandTile : m_tileManager->getVisibleTiles()) {
                 const std::shared_ptr<MapTile>& tile = mapIDandTile.second;
-                if (tile->hasGeometry()) {
+                if (tile->hasGeometry() && !tile->hasPendingUploads()) {
                     // Draw tile!
                     style->onBeginDrawTile(tile);
                     tile->draw(*style, *m_view);
@@ -191,6 +214,11 @@ namespace Tangram {
             style->onEndDrawFrame();
         }
 
+        // Tiles drawn for the first time report how long each stage of their construction took
+        for (const auto& mapIDandTile : m_tileManager->getVisibleTiles()) {
+            mapIDandTile.second->recordTiming();
+        }
+
         m_skybox->draw(*m_view);
 
         while (Error::hadGlError("Tangram::render()")) {}
@@ -236,6 +264,157 @@ namespace Tangram {
 
     }
 
+    void setNumTileWorkers(int _numWorkers) {
+
+        g_numTileWorkers = _numWorkers;
+
+        if (m_tileManager && _numWorkers > 0) {
+            m_tileManager->setNumWorkers(_numWorkers);
+        }
+
+    }
+
+    void setTileCacheSize(size_t _bytes) {
+
+        g_tileCacheSize = _bytes;
+
+        if (m_tileManager) {
+            m_tileManager->setCacheSize(_bytes);
+        }
+
+    }
+
+    void setTileDataBudget(size_t _bytes) {
+
+        g_tileDataBudget = _bytes;
+
+        if (m_tileManager) {
+            m_tileManager->setTileDataBudget(_bytes);
+        }
+
+    }
+
+    void setTilePrefetch(float _seconds, bool _buildTiles) {
+
+        g_prefetchTime = _seconds;
+        g_prefetchMode = _buildTiles ? PrefetchMode::build : PrefetchMode::parse;
+
+        if (m_view) {
+            m_view->setPrefetchTime(_seconds);
+        }
+
+        if (m_tileManager) {
+            m_tileManager->setPrefetchMode(_seconds > 0 ? g_prefetchMode : PrefetchMode::none);
+        }
+
+    }
+
+    bool setDiskCache(const std::string& _directory, size_t _maxBytes, double _maxAge) {
+
+        std::shared_ptr<DiskCache> cache;
+
+        if (!_directory.empty() && _maxBytes > 0) {
+            cache = std::make_shared<DiskCache>(_directory, _maxBytes, _maxAge);
+            if (!cache->open()) {
+                cache.reset();
+            }
+        }
+
+        g_diskCache = cache;
+
+        if (m_tileManager) {
+            m_tileManager->setDiskCache(cache);
+        }
+
+        return cache || _directory.empty() || _maxBytes == 0;
+
+    }
+
+    void setUploadBudget(size_t _bytes) {
+
+        g_uploadBudget = _bytes;
+
+        if (m_tileManager) {
+            m_tileManager->setUploadBudget(_bytes);
+        }
+
+    }
+
+    size_t getPendingUploadBytes() {
+
+        return m_tileManager ? m_tileManager->getPendingUploadBytes() : 0;
+
+    }
+
+    void setMemoryBudget(size_t _bytes) {
+
+        MemoryTracker::GetInstance().setBudget(_bytes);
+
+    }
+
+    void getMemoryUsage(size_t& _tileData, size_t& _meshData, size_t& _gpuBuffers, size_t& _textures) {
+
+        const auto& tracker = MemoryTracker::GetInstance();
+        _tileData = tracker.getUsage(MemoryCategory::tileData);
+        _meshData = tracker.getUsage(MemoryCategory::meshData);
+        _gpuBuffers = tracker.getUsage(MemoryCategory::gpuBuffers);
+        _textures = tracker.getUsage(MemoryCategory::textures);
+
+    }
+
+    bool updateStyleLayer(const std::string& _styleName, const std::string& _layerName, const StyleParamMap& _params) {
+
+        if (!m_scene) {
+            return false;
+        }
+
+        for (const auto& style : m_scene->getStyles()) {
+            if (style->getName() == _styleName) {
+                style->updateLayer(_layerName, _params);
+                m_tileManager->restyle(*style);
+                requestRender();
+                return true;
+            }
+        }
+
+        logMsg("WARNING: No style named %s to update\n", _styleName.c_str());
+        return false;
+
+    }
+
+    void addDataSource(std::unique_ptr<DataSource> _source) {
+
+        m_tileManager->addDataSource(std::move(_source));
+        m_view->setZoom(m_view->getZoom()); // Force the view to refresh
+
+    }
+
+    void clearDataSources() {
+
+        m_tileManager->clearDataSources();
+        m_view->setZoom(m_view->getZoom()); // Force the view to refresh
+
+    }
+
+    const TileStats& getStats() {
+
+        return TileStats::GetInstance();
+
+    }
+
+    void getTileCacheStats(unsigned long& _hits, unsigned long& _misses) {
+
+        if (m_tileManager) {
+            const TileCache& cache = m_tileManager->getTileCache();
+            _hits = cache.getHits();
+            _misses = cache.getMisses();
+        } else {
+            _hits = 0;
+            _misses = 0;
+        }
+
+    }
+
     void handleTapGesture(float _posX, float _posY) {
 
         float viewCenterX = 0.5f * m_view->getWidth();
@@ -334,6 +513,12 @@ namespace Tangram {
         // Buffer objects are invalidated and re-uploaded the next time they are used
         VboMesh::invalidateAllVBOs();
 
+        // Meshes that released their CPU data to fit the memory budget cannot be re-uploaded,
+        // so tiles are built again
+        if (VboMesh::hasReleasedData() && m_tileManager) {
+            m_tileManager->reloadTiles();
+        }
+
     }
 
 }
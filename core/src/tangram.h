@@ -2,6 +2,12 @@
 
 #include "platform.h"
 #include "debug.h"
+#include "style/styleParamMap.h"
+#include "tile/tileStats.h"
+
+#include <memory>
+
+class DataSource;
 
 /* Tangram API
  *
@@ -43,6 +49,55 @@ namespace Tangram {
     // Set the ratio of hardware pixels to logical pixels (defaults to 1.0)
     void setPixelScale(float _pixelsPerPoint);
 
+    // Set the number of threads used to build tiles (defaults to one less than the number of CPU cores)
+    void setNumTileWorkers(int _numWorkers);
+
+    // Set the memory budget in bytes for built tiles kept after they leave the view (defaults to 16MB)
+    void setTileCacheSize(size_t _bytes);
+
+    // Set the memory budget in bytes for parsed tile data kept by each data source to restyle tiles without fetching
+    // them again (defaults to 32MB); least recently used data is released first
+    void setTileDataBudget(size_t _bytes);
+
+    // Set how far ahead in seconds the motion of the view is extrapolated to prefetch tiles (0 disables prefetching);
+    // prefetched tiles are fully built if _buildTiles is true, otherwise their data is only fetched and parsed
+    void setTilePrefetch(float _seconds, bool _buildTiles);
+
+    // Keep the raw data of fetched tiles in the existing directory _directory, using at most _maxBytes, so that they
+    // are not requested again after a restart; data older than _maxAge seconds (0: no limit) is requested again.
+    // An empty _directory or a _maxBytes of 0 disables the cache. Returns false if the cache files can't be opened
+    bool setDiskCache(const std::string& _directory, size_t _maxBytes, double _maxAge);
+
+    // Set the number of bytes of vertex and index data uploaded to the GPU per frame (defaults to 1MB); tiles closest
+    // to the view center are uploaded first and new tiles are shown once all their geometry is uploaded
+    void setUploadBudget(size_t _bytes);
+
+    // Get the number of bytes of built geometry still waiting to be uploaded to the GPU
+    size_t getPendingUploadBytes();
+
+    // Set the total memory budget in bytes for tile data, meshes and textures (0, the default, means no limit);
+    // when exceeded, parsed data, CPU copies of uploaded meshes and cached tiles are released in that order
+    void setMemoryBudget(size_t _bytes);
+
+    // Set the values of the arguments to the number of bytes currently used in each memory category
+    void getMemoryUsage(size_t& _tileData, size_t& _meshData, size_t& _gpuBuffers, size_t& _textures);
+
+    // Replace the style parameters (e.g. color, width) of a data layer in the style named _styleName; built tiles
+    // are restyled from their parsed data without fetching it again. Returns false if there is no such style
+    bool updateStyleLayer(const std::string& _styleName, const std::string& _layerName, const StyleParamMap& _params);
+
+    // Add a source of tile data; sources are matched to the style layers by the names of the data layers they provide
+    void addDataSource(std::unique_ptr<DataSource> _source);
+
+    // Remove all sources of tile data, including those of the scene file, and discard the tiles built from them
+    void clearDataSources();
+
+    // Get histograms of the time spent by tiles in each stage of loading, from request to first draw
+    const TileStats& getStats();
+
+    // Set the values of the arguments to the number of tiles found and not found in the tile cache
+    void getTileCacheStats(unsigned long& _hits, unsigned long& _misses);
+
     // Respond to a tap at the given screen coordinates (x right, y down)
     void handleTapGesture(float _posX, float _posY);
 
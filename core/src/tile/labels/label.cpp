@@ -142,6 +142,10 @@ bool Label::canOcclude() {
     return (occludeFlags & m_currentState) && !(m_type == Type::DEBUG);
 }
 
+void Label::hide() {
+    enterState(State::OUT_OF_SCREEN, 0.0);
+}
+
 void Label::occlusionSolved() {
     m_occlusionSolved = true;
 }
@@ -113,6 +113,9 @@ public:
     void occlusionSolved();
 
     bool occludedLastFrame() { return m_occludedLastFrame; }
+
+    /* Hides the label until it is found inside the viewport again, e.g. when its tile stops being drawn */
+    void hide();
     
     State getState() const { return m_currentState; }
     
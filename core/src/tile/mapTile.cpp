@@ -26,7 +26,8 @@ MapTile::MapTile(TileID _id, const MapProjection& _projection) : m_id(_id),  m_p
 
 }
 
-MapTile::MapTile(MapTile&& _other) : m_id(std::move(m_id)), m_proxyCounter(std::move(_other.m_proxyCounter)), 
+MapTile::MapTile(MapTile&& _other) : m_id(std::move(m_id)), m_proxyCounter(std::move(_other.m_proxyCounter)), m_isReady(_other.m_isReady),
+                                     m_timing(std::move(_other.m_timing)), m_timingRecorded(_other.m_timingRecorded),
                                      m_projection(std::move(_other.m_projection)), m_scale(std::move(_other.m_scale)), 
                                      m_inverseScale(std::move(_other.m_inverseScale)), m_tileOrigin(std::move(_other.m_tileOrigin)), 
                                      m_modelMatrix(std::move(_other.m_modelMatrix)), m_geometry(std::move(_other.m_geometry)), 
@@ -43,6 +44,33 @@ void MapTile::addGeometry(const Style& _style, std::unique_ptr<VboMesh> _mesh) {
 
 }
 
+void MapTile::replaceStyleData(const Style& _style, MapTile& _source) {
+
+    const std::string name = _style.getName();
+
+    auto geometry = _source.m_geometry.find(name);
+    if (geometry != _source.m_geometry.end()) {
+        m_geometry[name] = std::move(geometry->second);
+    } else {
+        m_geometry.erase(name);
+    }
+
+    auto buffer = _source.m_buffers.find(name);
+    if (buffer != _source.m_buffers.end()) {
+        m_buffers[name] = std::move(buffer->second);
+    } else {
+        m_buffers.erase(name);
+    }
+
+    auto labels = _source.m_labels.find(name);
+    if (labels != _source.m_labels.end()) {
+        m_labels[name] = std::move(labels->second);
+    } else {
+        m_labels.erase(name);
+    }
+
+}
+
 void MapTile::setTextBuffer(const Style& _style, std::shared_ptr<TextBuffer> _buffer) {
 
     m_buffers[_style.getName()] = _buffer;
@@ -114,14 +142,121 @@ void MapTile::draw(const Style& _style, const View& _view) {
         // Set the tile zoom level, using the sign to indicate whether the tile is a proxy
         shader->setUniformf("u_tile_zoom", m_proxyCounter > 0 ? -m_id.z : m_id.z);
 
+        if (m_timing.firstDraw == 0) {
+            m_timing.firstDraw = TileTiming::now();
+        }
+
         styleMesh->draw(shader);
     }
 }
 
+size_t MapTile::uploadMeshes(size_t _maxBytes) {
+
+    size_t uploaded = 0;
+    double start = TileTiming::now();
+
+    for (auto& pair : m_geometry) {
+        auto& mesh = pair.second;
+        if (!mesh || !mesh->isCompiled() || mesh->isUploaded() || mesh->numVertices() == 0) {
+            continue;
+        }
+
+        size_t bytes = mesh->bufferSize();
+        if (uploaded > 0 && uploaded + bytes > _maxBytes) {
+            break;
+        }
+
+        mesh->upload();
+        uploaded += bytes;
+    }
+
+    if (uploaded > 0) {
+        m_timing.uploadTime += TileTiming::now() - start;
+        if (m_timing.firstUpload == 0) {
+            m_timing.firstUpload = start;
+        }
+    }
+
+    return uploaded;
+}
+
+size_t MapTile::getPendingUploadBytes() const {
+
+    size_t bytes = 0;
+
+    for (const auto& pair : m_geometry) {
+        const auto& mesh = pair.second;
+        if (mesh && mesh->isCompiled() && !mesh->isUploaded()) {
+            bytes += mesh->bufferSize();
+        }
+    }
+
+    return bytes;
+}
+
+bool MapTile::hasPendingUploads() const {
+
+    for (const auto& pair : m_geometry) {
+        const auto& mesh = pair.second;
+        if (mesh && mesh->isCompiled() && !mesh->isUploaded() && mesh->numVertices() > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MapTile::recordTiming() {
+
+    if (m_timingRecorded || m_timing.firstDraw == 0) {
+        return;
+    }
+
+    TileStats::GetInstance().record(m_timing);
+    m_timingRecorded = true;
+
+}
+
 bool MapTile::hasGeometry() {
     return (m_geometry.size() != 0);
 }
 
+size_t MapTile::getMemoryUsage() const {
+
+    size_t sum = 0;
+
+    for (const auto& pair : m_geometry) {
+        if (pair.second) {
+            sum += pair.second->getMemoryUsage();
+        }
+    }
+
+    return sum;
+}
+
+size_t MapTile::releaseMeshData() {
+
+    size_t freed = 0;
+
+    for (auto& pair : m_geometry) {
+        if (pair.second) {
+            freed += pair.second->releaseCpuData();
+        }
+    }
+
+    return freed;
+}
+
+void MapTile::hideLabels() {
+
+    for (auto& pair : m_labels) {
+        for (auto& label : pair.second) {
+            label->hide();
+        }
+    }
+
+}
+
 void MapTile::addLabel(const std::string& _styleName, std::shared_ptr<Label> _label) {
     m_labels[_styleName].push_back(std::move(_label));
 }
@@ -10,6 +10,7 @@
 #include "glm/vec2.hpp"
 
 #include "tileID.h"
+#include "tileStats.h"
 
 class Label;
 class LabelContainer;
@@ -65,6 +66,37 @@ public:
      */
     bool hasGeometry();
 
+    /* Marks the tile as fully built by all styles */
+    void setReady() { m_isReady = true; }
+
+    /* Returns true once the tile has been built; tiles waiting for their data are not ready */
+    bool isReady() const { return m_isReady; }
+
+    /* Returns the approximate number of bytes of mesh data held by this tile */
+    size_t getMemoryUsage() const;
+
+    /* Frees the CPU copies of all uploaded meshes; returns the number of bytes freed */
+    size_t releaseMeshData();
+
+    /* Uploads meshes that are not on the GPU yet until @_maxBytes of data are uploaded; the first mesh is
+     * always uploaded, even if larger than @_maxBytes. Returns the number of bytes uploaded */
+    size_t uploadMeshes(size_t _maxBytes);
+
+    /* Returns the number of bytes of mesh data waiting to be uploaded */
+    size_t getPendingUploadBytes() const;
+
+    /* Returns true while some meshes of this tile are not uploaded; such tiles are not drawn yet */
+    bool hasPendingUploads() const;
+
+    /* Hides all labels of this tile, e.g. when it is no longer drawn */
+    void hideLabels();
+
+    /* Returns the timestamps of the pipeline stages this tile went through */
+    TileTiming& getTiming() { return m_timing; }
+
+    /* Adds the timing of this tile to the <TileStats> once it has been drawn; later calls have no effect */
+    void recordTiming();
+
     /* uUdate the Tile considering the current view */
     void update(float _dt, const View& _view);
 
@@ -74,6 +106,9 @@ public:
     /* Push the label transforms to the font rendering context */
     void pushLabelTransforms(const Style& _style, std::shared_ptr<LabelContainer> _labelContainer);
 
+    /* Replaces the geometry, text buffer and labels of @_style by those of @_source, which are moved out of it */
+    void replaceStyleData(const Style& _style, MapTile& _source);
+
     void setTextBuffer(const Style& _style, std::shared_ptr<TextBuffer> _buffer);
     std::shared_ptr<TextBuffer> getTextBuffer(const Style& _style) const;
 
@@ -96,6 +131,11 @@ private:
      * A Counter for number of tiles this tile acts a proxy for
      */
     int m_proxyCounter = 0;
+
+    bool m_isReady = false;
+
+    TileTiming m_timing;
+    bool m_timingRecorded = false;
     
     const MapProjection* m_projection = nullptr;
     
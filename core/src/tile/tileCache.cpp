@@ -0,0 +1,109 @@
+#include "tileCache.h"
+#include "mapTile.h"
+
+const size_t TileCache::s_defaultCacheSize;
+
+TileCache::TileCache(size_t _maxBytes) : m_maxBytes(_maxBytes) {
+}
+
+void TileCache::put(std::shared_ptr<MapTile> _tile) {
+
+    const TileID& id = _tile->getID();
+
+    auto indexIt = m_index.find(id);
+    if (indexIt != m_index.end()) {
+        m_usedBytes -= indexIt->second->bytes;
+        m_entries.erase(indexIt->second);
+        m_index.erase(indexIt);
+    }
+
+    size_t bytes = _tile->getMemoryUsage();
+
+    if (bytes > m_maxBytes) {
+        // Would evict everything else and still not fit
+        return;
+    }
+
+    m_entries.push_front({ std::move(_tile), bytes });
+    m_index.emplace(id, m_entries.begin());
+    m_usedBytes += bytes;
+
+    evict();
+
+}
+
+std::shared_ptr<MapTile> TileCache::take(const TileID& _tileID) {
+
+    auto indexIt = m_index.find(_tileID);
+    if (indexIt == m_index.end()) {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+
+    auto entryIt = indexIt->second;
+    std::shared_ptr<MapTile> tile = std::move(entryIt->tile);
+
+    m_usedBytes -= entryIt->bytes;
+    m_entries.erase(entryIt);
+    m_index.erase(indexIt);
+
+    return tile;
+}
+
+void TileCache::clear() {
+
+    m_entries.clear();
+    m_index.clear();
+    m_usedBytes = 0;
+
+}
+
+void TileCache::setMaxBytes(size_t _maxBytes) {
+
+    m_maxBytes = _maxBytes;
+    evict();
+
+}
+
+size_t TileCache::releaseBytes(size_t _bytes) {
+
+    size_t freed = 0;
+
+    while (freed < _bytes && !m_entries.empty()) {
+        Entry& last = m_entries.back();
+        freed += last.bytes;
+        m_usedBytes -= last.bytes;
+        m_index.erase(last.tile->getID());
+        m_entries.pop_back();
+    }
+
+    return freed;
+}
+
+size_t TileCache::releaseMeshData(size_t _bytes) {
+
+    size_t freed = 0;
+
+    for (auto it = m_entries.rbegin(); it != m_entries.rend() && freed < _bytes; ++it) {
+        freed += it->tile->releaseMeshData();
+
+        size_t bytes = it->tile->getMemoryUsage();
+        m_usedBytes -= it->bytes - bytes;
+        it->bytes = bytes;
+    }
+
+    return freed;
+}
+
+void TileCache::evict() {
+
+    while (m_usedBytes > m_maxBytes && !m_entries.empty()) {
+        Entry& last = m_entries.back();
+        m_usedBytes -= last.bytes;
+        m_index.erase(last.tile->getID());
+        m_entries.pop_back();
+    }
+
+}
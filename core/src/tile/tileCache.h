@@ -0,0 +1,80 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+
+#include "util/tileID.h"
+
+class MapTile;
+
+/* Least-recently-used cache of built <MapTile>s
+ *
+ * Holds tiles that left the visible set together with their meshes and text buffers, so that they
+ * can be shown again without being rebuilt. The cache is bounded by the memory usage of its tiles;
+ * when the budget is exceeded the least recently used tiles are released. Only used from the main
+ * thread, since releasing a tile releases its OpenGL resources.
+ */
+class TileCache {
+
+public:
+
+    /* Creates a cache holding at most @_maxBytes of tile data */
+    TileCache(size_t _maxBytes = s_defaultCacheSize);
+
+    /* Adds a built tile to the cache, replacing any cached tile with the same <TileID> */
+    void put(std::shared_ptr<MapTile> _tile);
+
+    /* Removes and returns the tile for @_tileID, or nullptr if it is not cached */
+    std::shared_ptr<MapTile> take(const TileID& _tileID);
+
+    /* Returns true if a tile for @_tileID is cached; does not count as a hit or miss */
+    bool contains(const TileID& _tileID) const { return m_index.find(_tileID) != m_index.end(); }
+
+    /* Releases all cached tiles */
+    void clear();
+
+    /* Releases least recently used tiles until at least @_bytes are freed; returns the number of bytes freed */
+    size_t releaseBytes(size_t _bytes);
+
+    /* Frees CPU copies of mesh data, least recently used tiles first, until at least @_bytes are freed */
+    size_t releaseMeshData(size_t _bytes);
+
+    /* Sets the memory budget of the cache, releasing tiles as needed to fit it */
+    void setMaxBytes(size_t _maxBytes);
+
+    size_t getMaxBytes() const { return m_maxBytes; }
+
+    /* Returns the memory usage of all cached tiles, in bytes */
+    size_t getUsedBytes() const { return m_usedBytes; }
+
+    size_t getNumTiles() const { return m_entries.size(); }
+
+    /* Returns the number of calls to <take> that found a cached tile */
+    unsigned long getHits() const { return m_hits; }
+
+    /* Returns the number of calls to <take> that did not find a cached tile */
+    unsigned long getMisses() const { return m_misses; }
+
+    static const size_t s_defaultCacheSize = 16 * 1024 * 1024;
+
+private:
+
+    struct Entry {
+        std::shared_ptr<MapTile> tile;
+        size_t bytes;
+    };
+
+    /* Releases least recently used tiles until the cache fits in m_maxBytes */
+    void evict();
+
+    std::list<Entry> m_entries; // Most recently used first
+    std::map<TileID, std::list<Entry>::iterator> m_index;
+
+    size_t m_maxBytes;
+    size_t m_usedBytes = 0;
+
+    unsigned long m_hits = 0;
+    unsigned long m_misses = 0;
+
+};
@@ -2,90 +2,124 @@
 #include "scene/scene.h"
 #include "tile/mapTile.h"
 #include "view/view.h"
+#include "util/memoryTracker.h"
 
 #include <chrono>
 #include <algorithm>
+#include <cmath>
 
-TileManager::TileManager() {
-    // Instantiate workers
-    for (size_t i = 0; i < MAX_WORKERS; i++) {
-        m_workers.push_back(std::unique_ptr<TileWorker>(new TileWorker()));
-    }
-}
+TileManager::TileManager() : m_worker(new TileWorker()) {
+
+    auto& tracker = MemoryTracker::GetInstance();
+
+    // Parsed data is only needed to rebuild tiles, so data of tiles that are not shown goes first
+    m_evictionHandlers.push_back(tracker.addEvictionHandler(EvictionStage::tileData, [this](size_t _bytes) {
+        size_t freed = 0;
+        for (auto& source : m_dataSources) {
+            if (freed >= _bytes) { break; }
+            freed += source->evictTileData(_bytes - freed, [this](const TileID& _id) {
+                return m_tileSet.contains(_id) || m_prefetchTiles.count(_id) > 0;
+            });
+        }
+        return freed;
+    }));
+
+    // Uploaded meshes can drop their CPU copy, at the cost of rebuilding tiles after a context loss
+    m_evictionHandlers.push_back(tracker.addEvictionHandler(EvictionStage::meshData, [this](size_t _bytes) {
+        size_t freed = m_tileCache.releaseMeshData(_bytes);
+        for (const auto& entry : m_tileSet) {
+            if (freed >= _bytes) { break; }
+            freed += entry.second->releaseMeshData();
+        }
+        return freed;
+    }));
+
+    m_evictionHandlers.push_back(tracker.addEvictionHandler(EvictionStage::tiles, [this](size_t _bytes) {
+        return m_tileCache.releaseBytes(_bytes);
+    }));
 
-TileManager::TileManager(TileManager&& _other) :
-    m_view(std::move(_other.m_view)),
-    m_tileSet(std::move(_other.m_tileSet)),
-    m_dataSources(std::move(_other.m_dataSources)),
-    m_workers(std::move(_other.m_workers)),
-    m_queuedTiles(std::move(_other.m_queuedTiles)) {
 }
 
 TileManager::~TileManager() {
-    for (auto& worker : m_workers) {
-        if (!worker->isFree()) {
-            worker->abort();
-            worker->getTileResult();
-        }
-        // We stop all workers before we destroy the resources they use.
-        // TODO: This will wait for any pending network requests to finish,
-        // which could delay closing of the application. 
+    for (int id : m_evictionHandlers) {
+        MemoryTracker::GetInstance().removeEvictionHandler(id);
     }
+
+    // We stop the worker threads before we destroy the resources they use.
+    m_worker.reset();
     m_dataSources.clear();
     m_tileSet.clear();
+    m_tileCache.clear();
 }
 
 void TileManager::addToWorkerQueue(std::vector<char>&& _rawData, const TileID& _tileId, DataSource* _source) {
     
-    std::lock_guard<std::mutex> lock(m_queueTileMutex);
-    m_queuedTiles.emplace_back(std::unique_ptr<TileTask>(new TileTask(std::move(_rawData), _tileId, _source)));
+    std::shared_ptr<TileTask> task(new TileTask(std::move(_rawData), _tileId, _source));
+    m_worker->enqueue(std::move(task), m_scene, m_view);
     
 }
 
 void TileManager::addToWorkerQueue(std::shared_ptr<TileData>& _parsedData, const TileID& _tileID, DataSource* _source) {
 
-    std::lock_guard<std::mutex> lock(m_queueTileMutex);
-    m_queuedTiles.emplace_back(std::unique_ptr<TileTask>(new TileTask(_parsedData, _tileID, _source)));
+    std::shared_ptr<TileTask> task(new TileTask(_parsedData, _tileID, _source));
+    m_worker->enqueue(std::move(task), m_scene, m_view);
 
 }
 
 void TileManager::updateTileSet() {
     
     m_tileSetChanged = false;
-    
-    // Check if any native worker needs to be dispatched i.e. queuedTiles is not empty
-    {
-        auto workersIter = m_workers.begin();
-        auto queuedTilesIter = m_queuedTiles.begin();
 
-        while (workersIter != m_workers.end() && queuedTilesIter != m_queuedTiles.end()) {
+    // Check if any incoming tiles are finished
+    m_worker->takeFinishedTiles(m_finishedTiles);
+
+    for (auto& tile : m_finishedTiles) {
 
-            auto& worker = *workersIter;
+        const TileID& id = tile->getID();
 
-            if (worker->isFree()) {
-                worker->processTileData(std::move(*queuedTilesIter), m_scene->getStyles(), *m_view);
-                queuedTilesIter = m_queuedTiles.erase(queuedTilesIter);
-            }
+        auto requested = m_requestTimes.find(id);
+        if (requested != m_requestTimes.end()) {
+            tile->getTiming().requested = requested->second;
+            m_requestTimes.erase(requested);
+        }
 
-            ++workersIter;
+        auto setTile = m_tileSet.find(id);
+        if (!setTile) {
+            if (m_prefetchTiles.erase(id) > 0) {
+                // Prefetched tile, keep it until it comes into view; the worker no longer needs to track
+                // its priority, and results of other tasks for it would be dropped anyway
+                m_worker->cancel(id);
+                m_tileCache.put(std::move(tile));
+            }
+            // Otherwise the tile was removed while it was being built
+            continue;
         }
+
+        // Move result into tile set; its proxies are kept until its meshes are uploaded
+        logMsg("Tile [%d, %d, %d] finished loading\n", id.z, id.x, id.y);
+        std::swap(*setTile, tile);
+        m_uploadScheduler.add(*setTile);
+        m_tileSetChanged = true;
+
     }
 
-    // Check if any incoming tiles are finished
-    for (auto& worker : m_workers) {
-        
-        if (!worker->isFree() && worker->isFinished()) {
-            
-            // Get result from worker and move it into tile set
-            auto tile = worker->getTileResult();
-            const TileID& id = tile->getID();
-            logMsg("Tile [%d, %d, %d] finished loading\n", id.z, id.x, id.y);
-            std::swap(m_tileSet[id], tile);
-            cleanProxyTiles(id);
-            m_tileSetChanged = true;
-            
+    m_finishedTiles.clear();
+
+    m_worker->takeRestyledTiles(m_restyledTiles);
+
+    for (auto& restyled : m_restyledTiles) {
+        if (isLatestRestyle(restyled)) {
+            m_uploadScheduler.add(restyled.tile);
+            m_pendingRestyles.push_back(std::move(restyled));
         }
-        
+    }
+
+    m_restyledTiles.clear();
+
+    updateUploads();
+
+    if (m_view->prefetchChangedOnLastUpdate()) {
+        updatePrefetchTiles();
     }
     
     if (! (m_view->changedOnLastUpdate() || m_tileSetChanged) ) {
@@ -94,63 +128,235 @@ void TileManager::updateTileSet() {
         return;
     }
     
-    const std::set<TileID>& visibleTiles = m_view->getVisibleTiles();
-    
-    // Loop over visibleTiles and add any needed tiles to tileSet
-    {
-        auto setTilesIter = m_tileSet.begin();
-        auto visTilesIter = visibleTiles.begin();
-        
-        while (visTilesIter != visibleTiles.end()) {
-            
-            if (setTilesIter == m_tileSet.end() || *visTilesIter < setTilesIter->first) {
-                // tileSet is missing an element present in visibleTiles
-                addTile(*visTilesIter);
-                m_tileSetChanged = true;
-                ++visTilesIter;
-            } else if (setTilesIter->first < *visTilesIter) {
-                // visibleTiles is missing an element present in tileSet (handled below)
-                ++setTilesIter;
-            } else {
-                // tiles in both sets match, move on
-                ++setTilesIter;
-                ++visTilesIter;
+    if (m_view->changedOnLastUpdate()) {
+        // Tiles that are waiting to be built or loaded may have moved towards or away from the view center
+        m_worker->updatePriorities([this](const TileID& _id) { return getTilePriority(_id); });
+        for (const auto& entry : m_requestTimes) {
+            float priority = getTilePriority(entry.first);
+            for (auto& source : m_dataSources) {
+                source->setTilePriority(entry.first, priority);
             }
         }
     }
+
+    const std::set<TileID>& visibleTiles = m_view->getVisibleTiles();
     
-    // Loop over tileSet and remove any tiles that are neither visible nor proxies
-    {
-        auto setTilesIter = m_tileSet.begin();
-        auto visTilesIter = visibleTiles.begin();
-        
-        while (setTilesIter != m_tileSet.end()) {
-            
-            if (visTilesIter == visibleTiles.end() || setTilesIter->first < *visTilesIter) {
-                // visibleTiles is missing an element present in tileSet
-                if (setTilesIter->second->getProxyCounter() <= 0) {
-                    removeTile(setTilesIter);
-                    m_tileSetChanged = true;
-                } else {
-                    ++setTilesIter;
-                }
-            } else if (*visTilesIter < setTilesIter->first) {
-                // tileSet is missing an element present in visibleTiles (shouldn't occur)
-                ++visTilesIter;
-            } else {
-                // tiles in both sets match, move on
-                ++setTilesIter;
-                ++visTilesIter;
+    // Add any visible tiles missing from tileSet
+    for (const auto& id : visibleTiles) {
+        if (!m_tileSet.contains(id)) {
+            addTile(id);
+            m_tileSetChanged = true;
+        }
+    }
+
+    // Remove any tiles that are neither visible nor proxies; proxy counters change as tiles
+    // are removed, so they are checked one tile at a time
+    std::vector<TileID> hiddenTiles;
+    for (const auto& entry : m_tileSet) {
+        if (visibleTiles.count(entry.first) == 0) {
+            hiddenTiles.push_back(entry.first);
+        }
+    }
+
+    for (const auto& id : hiddenTiles) {
+        if ((*m_tileSet.find(id))->getProxyCounter() <= 0) {
+            removeTile(id);
+            m_tileSetChanged = true;
+        }
+    }
+}
+
+void TileManager::updateUploads() {
+
+    m_uploadScheduler.update([this](const TileID& _id) { return getTilePriority(_id); }, m_uploadedTiles);
+
+    for (auto& tile : m_uploadedTiles) {
+        auto setTile = m_tileSet.find(tile->getID());
+        if (setTile && *setTile == tile) {
+            cleanProxyTiles(tile->getID());
+            m_tileSetChanged = true;
+        }
+    }
+
+    m_uploadedTiles.clear();
+
+    for (auto it = m_pendingRestyles.begin(); it != m_pendingRestyles.end(); ) {
+        if (it->tile->hasPendingUploads()) {
+            ++it;
+            continue;
+        }
+
+        // The style may have been restyled again while the geometry was uploaded
+        auto setTile = m_tileSet.find(it->tile->getID());
+        if (setTile && (*setTile)->isReady() && isLatestRestyle(*it)) {
+            (*setTile)->replaceStyleData(*it->style, *it->tile);
+            m_tileSetChanged = true;
+        }
+
+        it = m_pendingRestyles.erase(it);
+    }
+
+}
+
+void TileManager::reloadTiles() {
+
+    for (const auto& entry : m_tileSet) {
+        for (auto& source : m_dataSources) {
+            source->cancelLoadingTile(entry.first);
+        }
+        m_worker->cancel(entry.first);
+    }
+
+    for (const auto& id : m_prefetchTiles) {
+        cancelPrefetch(id);
+    }
+
+    m_tileSet.clear();
+    m_prefetchTiles.clear();
+    m_tileCache.clear();
+    m_requestTimes.clear();
+    m_uploadScheduler.clear();
+    m_pendingRestyles.clear();
+
+    for (const auto& id : m_view->getVisibleTiles()) {
+        addTile(id);
+    }
+
+    m_tileSetChanged = true;
+
+}
+
+void TileManager::addDataSource(std::unique_ptr<DataSource> _source) {
+
+    _source->setDiskCache(m_diskCache);
+    _source->setStoreBudget(m_tileDataBudget);
+    m_dataSources.push_back(std::move(_source));
+
+}
+
+void TileManager::setDiskCache(std::shared_ptr<DiskCache> _cache) {
+
+    m_diskCache = _cache;
+
+    for (auto& source : m_dataSources) {
+        source->setDiskCache(_cache);
+    }
+
+}
+
+void TileManager::setTileDataBudget(size_t _bytes) {
+
+    m_tileDataBudget = _bytes;
+
+    for (auto& source : m_dataSources) {
+        source->setStoreBudget(_bytes);
+    }
+
+}
+
+void TileManager::clearDataSources() {
+
+    for (const auto& entry : m_tileSet) {
+        for (auto& source : m_dataSources) {
+            source->cancelLoadingTile(entry.first);
+        }
+    }
+
+    for (const auto& id : m_prefetchTiles) {
+        cancelPrefetch(id);
+    }
+
+    // Tasks keep pointers to their data source, so the worker threads are joined before the sources go
+    m_worker.reset(new TileWorker(m_worker->getNumThreads()));
+    m_dataSources.clear();
+
+    m_tileSet.clear();
+    m_prefetchTiles.clear();
+    m_tileCache.clear();
+    m_requestTimes.clear();
+    m_uploadScheduler.clear();
+    m_pendingRestyles.clear();
+
+    m_tileSetChanged = true;
+
+}
+
+void TileManager::restyle(Style& _style) {
+
+    // Cached tiles would come back with the previous style
+    m_tileCache.clear();
+
+    int generation = ++m_restyleGenerations[&_style];
+
+    for (const auto& entry : m_tileSet) {
+
+        // Tiles that are still loading are built with the new parameters
+        if (!entry.second->isReady()) {
+            continue;
+        }
+
+        const TileID& id = entry.first;
+
+        for (auto& source : m_dataSources) {
+            std::shared_ptr<TileData> data = source->getTileData(id);
+
+            if (data) {
+                std::shared_ptr<TileTask> task(new TileTask(data, id, source.get()));
+                task->restyle = &_style;
+                task->restyleGeneration = generation;
+                m_worker->enqueue(std::move(task), m_scene, m_view);
+            } else if (!source->loadTileData(id, *this)) {
+                logMsg("ERROR: Loading failed for tile [%d, %d, %d]\n", id.z, id.x, id.y);
             }
         }
     }
+
+}
+
+bool TileManager::isLatestRestyle(const RestyledTile& _restyled) const {
+
+    auto it = m_restyleGenerations.find(_restyled.style);
+    return it != m_restyleGenerations.end() && it->second == _restyled.generation;
+
 }
 
 void TileManager::addTile(const TileID& _tileID) {
+
+    std::shared_ptr<MapTile> cached = m_tileCache.take(_tileID);
+    if (cached) {
+        // Tile was built before, no data needs to be loaded; proxies are only needed while its meshes
+        // are uploaded, e.g. for prefetched tiles
+        bool pending = cached->hasPendingUploads();
+        m_tileSet[_tileID] = std::move(cached);
+        if (pending) {
+            m_uploadScheduler.add(m_tileSet[_tileID]);
+            updateProxyTiles(_tileID);
+        }
+        return;
+    }
     
     std::shared_ptr<MapTile> tile(new MapTile(_tileID, m_view->getMapProjection()));
     m_tileSet[_tileID] = std::move(tile);
 
+    // Set before loading, since data that is already available is queued right away
+    m_worker->setPriority(_tileID, getTilePriority(_tileID));
+
+    // Prefetched tiles keep the time of their original request
+    m_requestTimes.emplace(_tileID, TileTiming::now());
+
+    bool prefetched = m_prefetchTiles.erase(_tileID) > 0;
+
+    if (prefetched && m_prefetchMode == PrefetchMode::build) {
+        // The prefetched tile is on its way and will replace the placeholder when finished
+        updateProxyTiles(_tileID);
+        return;
+    }
+
+    if (prefetched) {
+        // Parsed data is picked up from the data sources if the prefetch finished already
+        m_worker->setParseOnly(_tileID, false);
+    }
+
     for (auto& source : m_dataSources) {
         
         if (!source->loadTileData(_tileID, *this)) {
@@ -164,55 +370,139 @@ void TileManager::addTile(const TileID& _tileID) {
     updateProxyTiles(_tileID);
 }
 
-void TileManager::removeTile(std::map< TileID, std::shared_ptr<MapTile> >::iterator& _tileIter) {
+void TileManager::removeTile(const TileID& _tileID) {
     
-    const TileID& id = _tileIter->first;
+    const TileID& id = _tileID;
 
-    // Make sure to cancel the network request associated with this tile, then if already fetched remove it from the proocessing queue and the worker managing this tile, if applicable
+    // Make sure to cancel the network request associated with this tile, then if already fetched remove it from the processing queue of the worker, if applicable
     for(auto& dataSource : m_dataSources) {
         dataSource->cancelLoadingTile(id);
         cleanProxyTiles(id);
     }
 
-    // Remove tile from queue, if present
-    const auto& found = std::find_if(m_queuedTiles.begin(), m_queuedTiles.end(), 
-                                        [&](std::unique_ptr<TileTask>& p) {
-                                            return (p->tileID == id);
-                                        });
+    m_worker->cancel(id);
 
-    if (found != m_queuedTiles.end()) {
-        m_queuedTiles.erase(found);
-        cleanProxyTiles(id);
+    m_requestTimes.erase(id);
+
+    // Keep built tiles around in case they come back into view
+    auto& tile = *m_tileSet.find(id);
+    if (tile->isReady()) {
+        tile->resetProxyCounter();
+        tile->hideLabels();
+        m_tileCache.put(std::move(tile));
     }
+
+    // Remove tile from set
+    m_tileSet.erase(id);
     
-    // If a worker is processing this tile, abort it
-    for (const auto& worker : m_workers) {
-        if (!worker->isFree() && worker->getTileID() == id) {
-            worker->abort();
-            // Proxy tiles will be cleaned in update loop
+}
+
+void TileManager::setPrefetchMode(PrefetchMode _mode) {
+
+    for (const auto& id : m_prefetchTiles) {
+        cancelPrefetch(id);
+    }
+    m_prefetchTiles.clear();
+
+    m_prefetchMode = _mode;
+
+}
+
+void TileManager::updatePrefetchTiles() {
+
+    const std::set<TileID>& prefetchTiles = m_view->getPrefetchTiles();
+    const std::set<TileID>& visibleTiles = m_view->getVisibleTiles();
+
+    // Cancel prefetches that left the predicted path; prefetches that came into view are taken over in addTile
+    for (auto it = m_prefetchTiles.begin(); it != m_prefetchTiles.end(); ) {
+        if (prefetchTiles.count(*it) == 0 && visibleTiles.count(*it) == 0) {
+            cancelPrefetch(*it);
+            it = m_prefetchTiles.erase(it);
+        } else {
+            ++it;
         }
     }
 
-    // Remove tile from set
-    _tileIter = m_tileSet.erase(_tileIter);
-    
+    if (m_prefetchMode == PrefetchMode::none) {
+        return;
+    }
+
+    for (const auto& id : prefetchTiles) {
+
+        if (m_tileSet.count(id) > 0 || m_prefetchTiles.count(id) > 0 || m_tileCache.contains(id)) {
+            continue;
+        }
+
+        m_prefetchTiles.insert(id);
+        m_requestTimes[id] = TileTiming::now();
+
+        // Prefetches are not visible, so they are always less urgent than visible tiles
+        m_worker->setPriority(id, getTilePriority(id));
+
+        if (m_prefetchMode == PrefetchMode::parse) {
+            m_worker->setParseOnly(id, true);
+        }
+
+        for (auto& source : m_dataSources) {
+            if (m_prefetchMode == PrefetchMode::parse && source->hasTileData(id)) {
+                continue;
+            }
+            source->loadTileData(id, *this);
+        }
+    }
+
+}
+
+void TileManager::cancelPrefetch(const TileID& _tileID) {
+
+    for (auto& source : m_dataSources) {
+        source->cancelLoadingTile(_tileID);
+    }
+
+    m_worker->cancel(_tileID);
+
+    m_requestTimes.erase(_tileID);
+
+}
+
+float TileManager::getTilePriority(const TileID& _tileID) const {
+
+    const MapProjection& projection = m_view->getMapProjection();
+
+    glm::dvec4 bounds = projection.TileBounds(_tileID);
+    glm::dvec2 center(0.5 * (bounds.x + bounds.z), -0.5 * (bounds.y + bounds.w));
+
+    // Size of a tile at the current zoom of the view, in projection meters
+    double viewTileSize = std::abs(bounds.z - bounds.x) * std::pow(2.0, _tileID.z - m_view->getZoom());
+
+    const glm::dvec3& viewPosition = m_view->getPosition();
+    double dx = center.x - viewPosition.x;
+    double dy = center.y - viewPosition.y;
+
+    float priority = std::sqrt(dx * dx + dy * dy) / viewTileSize;
+
+    priority += s_zoomPriorityWeight * std::abs((int)m_view->getZoom() - _tileID.z);
+
+    if (m_view->getVisibleTiles().count(_tileID) == 0) {
+        priority += s_proxyPriorityPenalty;
+    }
+
+    return priority;
 }
 
 void TileManager::updateProxyTiles(const TileID& _tileID) {
 
-    const auto& parentID = _tileID.getParent();
-    const auto& parentTileIter = m_tileSet.find(parentID);
-    if (parentTileIter != m_tileSet.end()) {
-        parentTileIter->second->incProxyCounter();
+    auto parentTile = m_tileSet.find(_tileID.getParent());
+    if (parentTile) {
+        (*parentTile)->incProxyCounter();
         return;
     }
 
     if (m_view->s_maxZoom > _tileID.z) {
       for(int i = 0; i < 4; i++) {
-        const auto& childID = _tileID.getChild(i);
-        const auto& childTileIter = m_tileSet.find(childID);
-        if(childTileIter != m_tileSet.end()) {
-          childTileIter->second->incProxyCounter();
+        auto childTile = m_tileSet.find(_tileID.getChild(i));
+        if (childTile) {
+          (*childTile)->incProxyCounter();
         }
       }
     }
@@ -221,19 +511,16 @@ void TileManager::updateProxyTiles(const TileID& _tileID) {
 
 void TileManager::cleanProxyTiles(const TileID& _tileID) {
     // check if parent proxy is present
-    const auto& parentID = _tileID.getParent();
-    const auto& parentTileIter = m_tileSet.find(parentID);
-    if (parentTileIter != m_tileSet.end()) {
-        parentTileIter->second->decProxyCounter();
+    auto parentTile = m_tileSet.find(_tileID.getParent());
+    if (parentTile) {
+        (*parentTile)->decProxyCounter();
     }
     
     // check if child proxies are present
     for(int i = 0; i < 4; i++) {
-        const auto& childID = _tileID.getChild(i);
-        const auto& childTileIter = m_tileSet.find(childID);
-        if (childTileIter != m_tileSet.end()) {
-            childTileIter->second->decProxyCounter();
+        auto childTile = m_tileSet.find(_tileID.getChild(i));
+        if (childTile) {
+            (*childTile)->decProxyCounter();
         }
     }
 }
-
@@ -1,21 +1,28 @@
 #pragma once
 
 #include <map>
-#include <list>
 #include <vector>
 #include <memory>
-#include <future>
 #include <set>
-#include <mutex>
 
 #include "tileWorker.h"
+#include "tileCache.h"
+#include "uploadScheduler.h"
 #include "util/tileID.h"
+#include "util/tileIndex.h"
 #include "data/dataSource.h"
 
 class Scene;
 class MapTile;
 class View;
 
+/* How far tiles predicted to come into view are processed ahead of time (see View::getPrefetchTiles) */
+enum class PrefetchMode {
+    none,   // Tiles are only loaded once visible
+    parse,  // Tile data is fetched and parsed, and kept by the data sources
+    build   // Tiles are fully built and kept in the tile cache
+};
+
 /* Singleton container of <MapTile>s
  *
  * TileManager is a singleton that maintains a set of MapTiles based on the current view into the map
@@ -30,19 +37,52 @@ public:
         return std::move(instance);
     }
 
-    /* Constructs a TileManager using move semantics */
-    TileManager(TileManager&& _other);
+    /* Not movable: eviction handlers and loading callbacks refer to this instance */
+    TileManager(TileManager&& _other) = delete;
 
     virtual ~TileManager();
 
     /* Sets the view for which the TileManager will maintain tiles */
     void setView(std::shared_ptr<View> _view) { m_view = _view; }
 
-    /* Sets the scene which the TileManager will use to style tiles */
-    void setScene(std::shared_ptr<Scene> _scene) { m_scene = _scene; }
+    /* Sets the scene which the TileManager will use to style tiles; cached tiles of the previous scene are released */
+    void setScene(std::shared_ptr<Scene> _scene) { m_scene = _scene; m_tileCache.clear(); m_uploadScheduler.clear(); }
 
     /* Adds a <DataSource> from which tile data should be retrieved */
-    void addDataSource(std::unique_ptr<DataSource> _source) { m_dataSources.push_back(std::move(_source)); }
+    void addDataSource(std::unique_ptr<DataSource> _source);
+
+    /* Sets the persistent cache of raw tile data used by all data sources, or none if @_cache is null */
+    void setDiskCache(std::shared_ptr<DiskCache> _cache);
+
+    /* Sets the memory budget, in bytes, for parsed tile data kept by each data source */
+    void setTileDataBudget(size_t _bytes);
+
+    /* Removes all data sources; tiles built from them are discarded after the tasks using the sources
+     * are finished, and visible tiles are loaded again from sources added afterwards */
+    void clearDataSources();
+
+    /* Sets the number of threads used to build tiles; tasks already queued are finished by the previous threads */
+    void setNumWorkers(size_t _numWorkers) { m_worker->setNumThreads(_numWorkers); }
+
+    size_t getNumWorkers() { return m_worker->getNumThreads(); }
+
+    /* Sets the memory budget, in bytes, for built tiles that are kept after they leave the view */
+    void setCacheSize(size_t _bytes) { m_tileCache.setMaxBytes(_bytes); }
+
+    /* Sets how predicted tiles are processed ahead of time; prefetches in progress are canceled */
+    void setPrefetchMode(PrefetchMode _mode);
+
+    PrefetchMode getPrefetchMode() const { return m_prefetchMode; }
+
+    /* Sets the number of bytes of mesh data uploaded to the GPU per update; built tiles are shown once
+     * all their meshes are uploaded, until then their proxies stay in place */
+    void setUploadBudget(size_t _bytes) { m_uploadScheduler.setBudget(_bytes); }
+
+    /* Returns the number of bytes of mesh data of built tiles waiting to be uploaded */
+    size_t getPendingUploadBytes() const { return m_uploadScheduler.getPendingBytes(); }
+
+    /* Returns the cache of built tiles that left the view */
+    const TileCache& getTileCache() const { return m_tileCache; }
 
     /* Updates visible tile set if necessary
      * 
@@ -51,12 +91,30 @@ public:
      */
     void updateTileSet();
 
+    /* Discards all built tiles, including cached and prefetched ones, and loads the visible tiles again */
+    void reloadTiles();
+
+    /* Rebuilds the geometry of @_style for all built tiles from their parsed data, e.g. after its layer
+     * parameters changed; the current geometry is shown until it is replaced. Tiles whose data is no
+     * longer stored are loaded again and cached tiles are released */
+    void restyle(Style& _style);
+
+    /*
+     * Returns the build and request priority of a tile for the current view; lower values are more urgent
+     *  @_tileID: TileID of a visible or prefetched tile
+     *
+     * Combines the distance from the view center to the tile center (in tiles at the view zoom) with
+     * the difference between the tile zoom and the view zoom, so that tiles under the center of the
+     * screen at the right level of detail load first
+     */
+    float getTilePriority(const TileID& _tileID) const;
+
     void addToWorkerQueue(std::vector<char>&& _rawData, const TileID& _id, DataSource* _source);
 
     void addToWorkerQueue(std::shared_ptr<TileData>& _parsedData, const TileID& _id, DataSource* _source);
     
     /* Returns the set of currently visible tiles */
-    const std::map<TileID, std::shared_ptr<MapTile>>& getVisibleTiles() { return m_tileSet; }
+    const TileIndex<std::shared_ptr<MapTile>>& getVisibleTiles() { return m_tileSet; }
     
     bool hasTileSetChanged() { return m_tileSetChanged; }
     
@@ -67,20 +125,55 @@ private:
     std::shared_ptr<View> m_view;
     std::shared_ptr<Scene> m_scene;
     
-    std::mutex m_queueTileMutex;
-    
-    // TODO: Might get away with using a vector of pairs here (and for searching using std:search (binary search))
-    std::map<TileID, std::shared_ptr<MapTile>> m_tileSet;
+    TileIndex<std::shared_ptr<MapTile>> m_tileSet;
     
     std::vector<std::unique_ptr<DataSource>> m_dataSources;
 
-    const static size_t MAX_WORKERS = 4;
-    std::list<std::unique_ptr<TileWorker> > m_workers;
-    
-    std::list<std::unique_ptr<TileTask> > m_queuedTiles;
+    std::shared_ptr<DiskCache> m_diskCache;
+
+    size_t m_tileDataBudget = DataSource::s_defaultStoreBudget;
+
+    std::unique_ptr<TileWorker> m_worker;
+
+    std::vector<std::shared_ptr<MapTile>> m_finishedTiles; // Scratch space for tiles returned by m_worker
+    std::vector<RestyledTile> m_restyledTiles; // Scratch space for restyled geometry returned by m_worker
+    std::vector<RestyledTile> m_pendingRestyles; // Restyled geometry waiting for its upload
+
+    // Number of the latest restyle of each style; geometry of earlier restyles is dropped, whichever order
+    // the tasks finish in
+    std::map<const Style*, int> m_restyleGenerations;
+
+    UploadScheduler m_uploadScheduler; // Uploads meshes of built tiles within a budget per update
+    std::vector<std::shared_ptr<MapTile>> m_uploadedTiles; // Scratch space for tiles returned by m_uploadScheduler
+
+    TileCache m_tileCache; // Built tiles that left the view, restored without rebuilding when they come back
+
+    PrefetchMode m_prefetchMode = PrefetchMode::build;
+    std::set<TileID> m_prefetchTiles; // Tiles requested ahead of time, whose data or tile has not arrived yet
+
+    std::map<TileID, double> m_requestTimes; // Time at which data was requested for tiles being built, see <TileTiming>
     
     bool m_tileSetChanged = false;
+
+    std::vector<int> m_evictionHandlers; // Ids of the handlers registered with the MemoryTracker
+
+    // Priority cost of one zoom level between a tile and the view, in tile lengths of distance
+    static constexpr float s_zoomPriorityWeight = 2.f;
+
+    // Priority cost added to tiles that are only kept as proxies for visible tiles
+    static constexpr float s_proxyPriorityPenalty = 100.f;
     
+    /*
+     * Uploads meshes of built tiles within the upload budget; tiles in m_tileSet that are fully
+     * uploaded replace their proxies and restyled geometry replaces the geometry of its tile
+     */
+    void updateUploads();
+
+    /*
+     * Returns whether @_restyled belongs to the latest restyle of its style
+     */
+    bool isLatestRestyle(const RestyledTile& _restyled) const;
+
     /*
      * Constructs a future (async) to load data of a new visible tile
      *      this is also responsible for loading proxy tiles for the newly visible tiles
@@ -88,10 +181,21 @@ private:
      */
     void addTile(const TileID& _tileID);
     
+    /*
+     * Requests data for tiles that the view predicts will come into view and cancels requests
+     * for tiles that are no longer predicted
+     */
+    void updatePrefetchTiles();
+
+    /*
+     * Cancels the data requests and tasks of a prefetched tile
+     */
+    void cancelPrefetch(const TileID& _tileID);
+
     /*
      * Removes a tile from m_tileSet
      */
-    void removeTile(std::map<TileID, std::shared_ptr<MapTile>>::iterator& _tileIter);
+    void removeTile(const TileID& _tileID);
     
     /*
      * Checks and updates m_tileSet with proxy tiles for every new visible tile
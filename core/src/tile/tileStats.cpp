@@ -0,0 +1,63 @@
+#include "tileStats.h"
+
+#include <chrono>
+
+double TileTiming::now() {
+
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+
+}
+
+void TileStats::record(const TileTiming& _timing) {
+
+    auto addInterval = [this](TileStage _stage, double _start, double _end) {
+        if (_start > 0 && _end >= _start) {
+            m_stages[(int)_stage].add(1000 * (_end - _start));
+        }
+    };
+
+    addInterval(TileStage::network, _timing.requested, _timing.received);
+    addInterval(TileStage::queue, _timing.received, _timing.parseStart > 0 ? _timing.parseStart : _timing.buildStart);
+    addInterval(TileStage::parse, _timing.parseStart, _timing.parseEnd);
+    addInterval(TileStage::build, _timing.buildStart, _timing.buildEnd);
+    addInterval(TileStage::present, _timing.buildEnd, _timing.firstDraw);
+    addInterval(TileStage::total, _timing.requested, _timing.firstDraw);
+
+    if (_timing.buildEnd > 0) {
+        m_stages[(int)TileStage::compile].add(1000 * _timing.compileTime);
+    }
+    if (_timing.firstUpload > 0) {
+        m_stages[(int)TileStage::upload].add(1000 * _timing.uploadTime);
+    }
+
+    for (const auto& build : _timing.styles) {
+        m_styles[build.style].add(1000 * (build.end - build.start));
+    }
+
+}
+
+const char* TileStats::getStageName(TileStage _stage) {
+
+    switch (_stage) {
+        case TileStage::network: return "network";
+        case TileStage::queue: return "queue";
+        case TileStage::parse: return "parse";
+        case TileStage::build: return "build";
+        case TileStage::compile: return "compile";
+        case TileStage::upload: return "upload";
+        case TileStage::present: return "present";
+        case TileStage::total: return "total";
+        default: return "";
+    }
+
+}
+
+void TileStats::reset() {
+
+    for (auto& histogram : m_stages) {
+        histogram.clear();
+    }
+    m_styles.clear();
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "util/histogram.h"
+
+/* Timestamps of the stages of the tile pipeline for one tile, in seconds of <TileTiming::now>
+ *
+ * A timestamp of 0 means that the stage did not happen for this tile, e.g. data that was already
+ * parsed is not received or parsed again.
+ */
+struct TileTiming {
+
+    struct StyleBuild {
+        std::string style;
+        double start;
+        double end;
+    };
+
+    double requested = 0;   // Data requested from the data sources
+    double received = 0;    // Data received and queued for the worker
+    double parseStart = 0;
+    double parseEnd = 0;
+    double buildStart = 0;
+    double buildEnd = 0;    // Built by all styles
+    double firstUpload = 0; // Start of the first upload of a mesh of the tile
+    double firstDraw = 0;
+
+    std::vector<StyleBuild> styles; // Build start and end for each style
+
+    double compileTime = 0; // Total time spent compiling meshes, in seconds
+    double uploadTime = 0;  // Total time spent in first uploads of meshes, in seconds
+
+    /* Returns the current time in seconds on a monotonic clock */
+    static double now();
+
+};
+
+/* Stages of the tile pipeline aggregated by <TileStats> */
+enum class TileStage {
+    network,    // requested -> received
+    queue,      // received -> parse or build start
+    parse,      // parse start -> parse end
+    build,      // build start -> build end, all styles
+    compile,    // compileVertexBuffer, all meshes
+    upload,     // first upload, all meshes
+    present,    // build end -> first draw
+    total,      // requested -> first draw
+    count
+};
+
+/* Per-stage histograms of tile pipeline latencies
+ *
+ * The timing of each tile is recorded once, after it is first drawn. Only used from the main thread.
+ */
+class TileStats {
+
+public:
+
+    static TileStats& GetInstance() {
+        static TileStats instance;
+        return instance;
+    }
+
+    /* Adds the durations of the stages in @_timing to the histograms */
+    void record(const TileTiming& _timing);
+
+    /* Returns the distribution of durations of @_stage, in milliseconds */
+    const Histogram& getHistogram(TileStage _stage) const { return m_stages[(int)_stage]; }
+
+    /* Returns the distributions of build durations of each style, in milliseconds */
+    const std::map<std::string, Histogram>& getStyleHistograms() const { return m_styles; }
+
+    static const char* getStageName(TileStage _stage);
+
+    /* Clears all recorded samples */
+    void reset();
+
+private:
+
+    TileStats() {}
+
+    Histogram m_stages[(int)TileStage::count];
+
+    std::map<std::string, Histogram> m_styles;
+
+};
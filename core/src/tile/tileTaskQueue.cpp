@@ -0,0 +1,102 @@
+#include "tileTaskQueue.h"
+#include "tileWorker.h"
+
+const size_t TileTaskQueue::NOT_QUEUED;
+
+void TileTaskQueue::push(std::shared_ptr<TileTask> _task) {
+
+    _task->queueIndex = m_heap.size();
+    m_heap.push_back(std::move(_task));
+    siftUp(m_heap.size() - 1);
+
+}
+
+std::shared_ptr<TileTask> TileTaskQueue::pop() {
+
+    if (m_heap.empty()) {
+        return nullptr;
+    }
+
+    swap(0, m_heap.size() - 1);
+
+    std::shared_ptr<TileTask> task = std::move(m_heap.back());
+    m_heap.pop_back();
+    task->queueIndex = NOT_QUEUED;
+
+    if (!m_heap.empty()) {
+        siftDown(0);
+    }
+
+    return task;
+}
+
+void TileTaskQueue::remove(const TileTask& _task) {
+
+    size_t index = _task.queueIndex;
+
+    if (index >= m_heap.size() || m_heap[index].get() != &_task) {
+        return;
+    }
+
+    size_t last = m_heap.size() - 1;
+
+    swap(index, last);
+    m_heap.back()->queueIndex = NOT_QUEUED;
+    m_heap.pop_back();
+
+    if (index < m_heap.size()) {
+        siftUp(index);
+        siftDown(index);
+    }
+
+}
+
+void TileTaskQueue::reorder() {
+
+    for (size_t i = m_heap.size() / 2; i-- > 0; ) {
+        siftDown(i);
+    }
+
+}
+
+void TileTaskQueue::siftUp(size_t _index) {
+
+    while (_index > 0) {
+        size_t parent = (_index - 1) / 2;
+        if (m_heap[parent]->priority <= m_heap[_index]->priority) {
+            break;
+        }
+        swap(parent, _index);
+        _index = parent;
+    }
+
+}
+
+void TileTaskQueue::siftDown(size_t _index) {
+
+    size_t size = m_heap.size();
+
+    while (true) {
+        size_t left = 2 * _index + 1;
+        size_t right = left + 1;
+        size_t smallest = _index;
+
+        if (left < size && m_heap[left]->priority < m_heap[smallest]->priority) { smallest = left; }
+        if (right < size && m_heap[right]->priority < m_heap[smallest]->priority) { smallest = right; }
+
+        if (smallest == _index) {
+            break;
+        }
+        swap(smallest, _index);
+        _index = smallest;
+    }
+
+}
+
+void TileTaskQueue::swap(size_t _a, size_t _b) {
+
+    std::swap(m_heap[_a], m_heap[_b]);
+    m_heap[_a]->queueIndex = _a;
+    m_heap[_b]->queueIndex = _b;
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+struct TileTask;
+
+/* Indexed priority queue of <TileTask>s
+ *
+ * A binary min-heap on TileTask::priority: the task with the lowest priority value is popped first.
+ * Each task stores its own position in the heap, so that it can be removed or re-prioritized in
+ * O(log n) without searching the queue. The queue is not synchronized; the owner must guard it.
+ */
+class TileTaskQueue {
+
+public:
+
+    /* Adds @_task to the queue, ordered by its current priority */
+    void push(std::shared_ptr<TileTask> _task);
+
+    /* Removes and returns the task with the lowest priority value, or nullptr if the queue is empty */
+    std::shared_ptr<TileTask> pop();
+
+    /* Removes @_task from the queue, if it is queued */
+    void remove(const TileTask& _task);
+
+    /* Restores heap order after any number of priorities were changed in place, in O(n) */
+    void reorder();
+
+    bool empty() const { return m_heap.empty(); }
+
+    size_t size() const { return m_heap.size(); }
+
+    static const size_t NOT_QUEUED = size_t(-1);
+
+private:
+
+    void siftUp(size_t _index);
+    void siftDown(size_t _index);
+    void swap(size_t _a, size_t _b);
+
+    std::vector<std::shared_ptr<TileTask>> m_heap;
+
+};
@@ -1,76 +1,422 @@
 #include "tileWorker.h"
 #include "platform.h"
+#include "scene/scene.h"
 #include "view/view.h"
 #include "style/style.h"
+#include "util/bufferPool.h"
 
-#include <chrono>
+#include <algorithm>
 
-TileWorker::TileWorker() {
-    m_free = true;
-    m_aborted = false;
-    m_finished = false;
+TileWorker::TileWorker(size_t _numThreads) : m_pool(std::make_shared<ThreadPool>(_numThreads)) {
 }
 
-void TileWorker::abort() {
-    m_aborted = true;
+TileWorker::~TileWorker() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        for (auto& entry : m_tasks) {
+            entry.second->cancelToken.cancel();
+        }
+    }
+
+    std::shared_ptr<ThreadPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        std::swap(pool, m_pool);
+    }
+
+    // Joins the worker threads; remaining jobs see that their task is canceled and return right away
+    pool.reset();
+
 }
 
-void TileWorker::processTileData(std::unique_ptr<TileTask> _task,
-                                 const std::vector<std::unique_ptr<Style>>& _styles,
-                                 const View& _view) {
+void TileWorker::setNumThreads(size_t _numThreads) {
 
-    m_task = std::move(_task);
-    m_free = false;
-    m_finished = false;
-    m_aborted = false;
+    std::shared_ptr<ThreadPool> previous;
 
-    m_future = std::async(std::launch::async, [&]() {
-        
-        const TileID& tileID = m_task->tileID;
-        DataSource* dataSource = m_task->source;
-        
-        auto tile = std::shared_ptr<MapTile>(new MapTile(tileID, _view.getMapProjection()));
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        previous = m_pool;
+        m_pool = std::make_shared<ThreadPool>(_numThreads);
+    }
 
-        std::shared_ptr<TileData> tileData;
+    // Joins the previous threads; their queued jobs move to the new threads instead of building tiles, so
+    // this only waits for the tiles being built right now
+    previous.reset();
 
-        if (m_task->parsedTileData) {
-            // Data has already been parsed!
-            tileData = m_task->parsedTileData;
-        } else {
-            // Data needs to be parsed
-            tileData = dataSource->parse(*tile, m_task->rawTileData);
+}
+
+size_t TileWorker::getNumThreads() {
+
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    return m_pool->size();
 
-            // Cache parsed data with the original data source
-            dataSource->setTileData(tileID, tileData);
+}
+
+void TileWorker::enqueue(std::shared_ptr<TileTask> _task, std::shared_ptr<Scene> _scene, std::shared_ptr<View> _view) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+
+        auto priorityIt = m_priorities.find(_task->tileID);
+        if (priorityIt != m_priorities.end()) {
+            _task->priority = priorityIt->second;
         }
-        
-		tile->update(0, _view);
-
-        //Process data for all styles
-        for(const auto& style : _styles) {
-            if(m_aborted) {
-                m_finished = true;
-                return std::move(tile);
-            }
-            if(tileData) {
-                style->addData(*tileData, *tile, _view.getMapProjection());
+
+        _task->parseOnly = m_parseOnly.count(_task->tileID) > 0;
+
+        m_tasks.emplace(_task->tileID, _task);
+        m_queue.push(std::move(_task));
+    }
+
+    std::shared_ptr<ThreadPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        pool = m_pool;
+    }
+
+    post(*pool, _scene, _view);
+
+}
+
+void TileWorker::post(ThreadPool& _pool, std::shared_ptr<Scene> _scene, std::shared_ptr<View> _view) {
+
+    ThreadPool* pool = &_pool;
+
+    // Each job runs whichever task is the most urgent once a thread is free; jobs
+    // left over from canceled tasks find the queue drained and return right away
+    _pool.enqueue([=]() {
+
+        std::shared_ptr<ThreadPool> current;
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            current = m_pool;
+        }
+
+        if (current.get() != pool) {
+            // The threads of this job were replaced, see <setNumThreads>; without threads the worker is
+            // being destroyed and all tasks are canceled
+            if (current) {
+                post(*current, _scene, _view);
             }
+            return;
         }
-        m_finished = true;
-        
-        requestRender();
-        
-        // Return finished tile
-        return std::move(tile);
 
+        auto task = next();
+        if (task) {
+            process(task, *_scene, *_view);
+            release(task);
+        }
     });
 
 }
 
-std::shared_ptr<MapTile> TileWorker::getTileResult() {
+void TileWorker::cancel(const TileID& _tileID) {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    auto range = m_tasks.equal_range(_tileID);
+    for (auto it = range.first; it != range.second; ++it) {
+        it->second->cancelToken.cancel();
+        m_queue.remove(*it->second);
+    }
+    m_tasks.erase(range.first, range.second);
+
+    m_priorities.erase(_tileID);
+    m_parseOnly.erase(_tileID);
 
-    m_free = true;
-    return std::move(m_future.get());
-    
 }
 
+void TileWorker::setParseOnly(const TileID& _tileID, bool _parseOnly) {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    if (_parseOnly) {
+        m_parseOnly.insert(_tileID);
+    } else {
+        m_parseOnly.erase(_tileID);
+    }
+
+}
+
+void TileWorker::setPriority(const TileID& _tileID, float _priority) {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    m_priorities[_tileID] = _priority;
+
+    auto range = m_tasks.equal_range(_tileID);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto& task = *it->second;
+        if (task.queueIndex != TileTaskQueue::NOT_QUEUED) {
+            m_queue.remove(task);
+            task.priority = _priority;
+            m_queue.push(it->second);
+        }
+    }
+
+}
+
+void TileWorker::updatePriorities(const std::function<float(const TileID&)>& _priority) {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    for (auto& entry : m_priorities) {
+        entry.second = _priority(entry.first);
+    }
+
+    for (auto& entry : m_tasks) {
+        entry.second->priority = m_priorities[entry.first];
+    }
+
+    m_queue.reorder();
+
+}
+
+std::shared_ptr<TileTask> TileWorker::next() {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+    return m_queue.pop();
+
+}
+
+void TileWorker::release(const std::shared_ptr<TileTask>& _task) {
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    auto range = m_tasks.equal_range(_task->tileID);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == _task) {
+            m_tasks.erase(it);
+            break;
+        }
+    }
+
+}
+
+void TileWorker::takeFinishedTiles(std::vector<std::shared_ptr<MapTile>>& _tiles) {
+
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+
+    _tiles.insert(_tiles.end(), m_finishedTiles.begin(), m_finishedTiles.end());
+    m_finishedTiles.clear();
+
+}
+
+std::shared_ptr<TileData> TileWorker::beginParse(DataSource* _source, const TileID& _dataID) {
+
+    std::unique_lock<std::mutex> lock(m_parseMutex);
+
+    auto key = std::make_pair(_source, _dataID);
+
+    m_parseDone.wait(lock, [&] { return m_parsing.count(key) == 0; });
+
+    std::shared_ptr<TileData> tileData = _source->getTileData(_dataID);
+
+    if (!tileData) {
+        m_parsing.insert(key);
+    }
+
+    return tileData;
+}
+
+void TileWorker::endParse(DataSource* _source, const TileID& _dataID) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_parseMutex);
+        m_parsing.erase(std::make_pair(_source, _dataID));
+    }
+
+    m_parseDone.notify_all();
+
+}
+
+void TileWorker::process(std::shared_ptr<TileTask> _task, const Scene& _scene, const View& _view) {
+
+    if (_task->cancelToken.isCanceled()) {
+        return;
+    }
+
+    const TileID& tileID = _task->tileID;
+    DataSource* dataSource = _task->source;
+
+    auto tile = std::shared_ptr<MapTile>(new MapTile(tileID, _view.getMapProjection()));
+
+    TileTiming& timing = tile->getTiming();
+    timing.received = _task->receivedTime;
+
+    std::shared_ptr<TileData> tileData;
+
+    // Above the maximum zoom of the source, data belongs to an ancestor of the tile
+    TileID dataID = dataSource->getDataTileID(tileID);
+    bool overzoomed = !(dataID == tileID);
+
+    if (_task->parsedTileData) {
+        // Data has already been parsed!
+        tileData = _task->parsedTileData;
+    } else if ((tileData = beginParse(dataSource, dataID))) {
+        // Parsed for another task meanwhile, e.g. an overzoomed sibling with a copy of the same data
+        BufferPool::GetInstance().release(std::move(_task->rawTileData));
+    } else {
+        // Data needs to be parsed
+        timing.parseStart = TileTiming::now();
+        if (overzoomed) {
+            MapTile dataTile(dataID, _view.getMapProjection());
+            tileData = dataSource->parse(dataTile, _task->rawTileData, _task->cancelToken);
+        } else {
+            tileData = dataSource->parse(*tile, _task->rawTileData, _task->cancelToken);
+        }
+        timing.parseEnd = TileTiming::now();
+
+        // Parsed data doesn't refer to the raw data, so its buffer can take the next response
+        BufferPool::GetInstance().release(std::move(_task->rawTileData));
+
+        if (_task->cancelToken.isCanceled()) {
+            // Parsing stopped early, the data is incomplete; a waiting task parses its own copy
+            endParse(dataSource, dataID);
+            return;
+        }
+
+        // Detail below the tolerance in pixels is dropped once, before the data is cached. A tile spans 2
+        // units, so the tolerance in tile units follows the zoom of the data. Data at the maximum zoom of
+        // the source keeps full resolution, since it is magnified by overzoomed tiles
+        if (tileData && dataSource->getSimplifyTolerance() > 0 && dataID.z < dataSource->getMaxZoom()) {
+            DataSource::simplifyTileData(*tileData, 2 * dataSource->getSimplifyTolerance() / _view.getPixelsPerTile());
+        }
+
+        // Cache parsed data with the original data source
+        dataSource->setTileData(dataID, tileData);
+        endParse(dataSource, dataID);
+    }
+
+    if (_task->parseOnly) {
+        return;
+    }
+
+    if (overzoomed && tileData) {
+        tileData = dataSource->sliceTileData(*tileData, dataID, tileID);
+    }
+
+    tile->update(0, _view);
+
+    timing.buildStart = TileTiming::now();
+
+    // Process data for all styles
+    std::vector<Style*> styles;
+    for (const auto& style : _scene.getStyles()) {
+        if (!_task->restyle || style.get() == _task->restyle) {
+            styles.push_back(style.get());
+        }
+    }
+
+    if (tileData) {
+        buildStyles(styles, *tileData, *tile, *_task, _view);
+    }
+
+    timing.buildEnd = TileTiming::now();
+
+    if (_task->cancelToken.isCanceled()) {
+        return;
+    }
+
+    if (_task->restyle) {
+        // The geometry is moved into the existing tile by the main thread
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        m_restyledTiles.push_back({ std::move(tile), _task->restyle, _task->restyleGeneration });
+    } else {
+        tile->setReady();
+
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        m_finishedTiles.push_back(std::move(tile));
+    }
+
+    requestRender();
+
+}
+
+void TileWorker::buildStyles(const std::vector<Style*>& _styles, const TileData& _data, MapTile& _tile,
+                             const TileTask& _task, const View& _view) {
+
+    if (_styles.empty()) {
+        return;
+    }
+
+    struct Build {
+        const size_t count;
+        const std::vector<Style*>& styles;
+        const TileData& data;
+        const TileTask& task;
+        const View& view;
+        std::vector<std::shared_ptr<MapTile>> tiles; // One tile per style, merged into _tile at the end
+        std::vector<TileTiming::StyleBuild> timings;
+        std::atomic<size_t> next;
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        Build(const std::vector<Style*>& _styles, const TileData& _data, const TileTask& _task, const View& _view)
+            : count(_styles.size()), styles(_styles), data(_data), task(_task), view(_view),
+              tiles(_styles.size()), timings(_styles.size()), next(0) {}
+
+        // Builds styles until none is left; helpers that start after all styles were taken return
+        // right away, without touching the references, which are only valid while buildStyles runs
+        void run() {
+            for (size_t i = next++; i < count; i = next++) {
+                auto tile = std::make_shared<MapTile>(task.tileID, view.getMapProjection());
+                tile->update(0, view);
+
+                double start = TileTiming::now();
+                if (!task.cancelToken.isCanceled()) {
+                    styles[i]->addData(data, *tile, view.getMapProjection(), task.cancelToken);
+                }
+                timings[i] = { styles[i]->getName(), start, TileTiming::now() };
+                tiles[i] = std::move(tile);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++done == count) {
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+
+    auto build = std::make_shared<Build>(_styles, _data, _task, _view);
+
+    std::shared_ptr<ThreadPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        pool = m_pool;
+    }
+
+    // Idle threads help with the styles of this tile; the current thread builds whatever they do not pick
+    // up, so it only ever waits for styles that are already being built
+    size_t helpers = pool ? std::min(_styles.size(), pool->size()) - 1 : 0;
+    for (size_t i = 0; i < helpers; i++) {
+        pool->enqueue([build]() { build->run(); });
+    }
+
+    build->run();
+
+    {
+        std::unique_lock<std::mutex> lock(build->mutex);
+        build->finished.wait(lock, [&]() { return build->done == _styles.size(); });
+    }
+
+    TileTiming& timing = _tile.getTiming();
+
+    for (size_t i = 0; i < _styles.size(); i++) {
+        _tile.replaceStyleData(*_styles[i], *build->tiles[i]);
+        timing.styles.push_back(build->timings[i]);
+        timing.compileTime += build->tiles[i]->getTiming().compileTime;
+    }
+
+}
+
+void TileWorker::takeRestyledTiles(std::vector<RestyledTile>& _tiles) {
+
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+
+    _tiles.insert(_tiles.end(), m_restyledTiles.begin(), m_restyledTiles.end());
+    m_restyledTiles.clear();
+
+}
@@ -1,11 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
 #include <memory>
-#include <future>
+#include <mutex>
+#include <set>
+#include <vector>
 
 #include "util/tileID.h"
+#include "util/cancelToken.h"
+#include "util/threadPool.h"
 #include "data/dataSource.h"
 #include "mapTile.h"
+#include "tileStats.h"
+#include "tileTaskQueue.h"
+
+class Scene;
+class Style;
 
 struct TileTask {
 
@@ -13,63 +26,139 @@ struct TileTask {
 
     // Only one of either parsedTileData or rawTileData will be non-empty for a given task.
     // If parsedTileData is non-empty, then the data for this tile was previously fetched
-    // and parsed. Otherwise rawTileData will be non-empty, indicating that the data needs 
-    // to be parsed using the given DataSource. 
+    // and parsed. Otherwise rawTileData will be non-empty, indicating that the data needs
+    // to be parsed using the given DataSource.
     std::shared_ptr<TileData> parsedTileData;
     std::vector<char> rawTileData;
     DataSource* source;
 
-    TileTask() : tileID(NOT_A_TILE) {
-    }
+    // Canceled when the tile is no longer needed; polled while parsing and styling the tile
+    CancelToken cancelToken;
+
+    // Tasks with lower values are processed first (see TileManager::getTilePriority)
+    float priority = 0;
+
+    // Set for tasks that only parse and store the tile data, e.g. when prefetching; no tile is built
+    bool parseOnly = false;
+
+    // Set for tasks that rebuild the geometry of a single style for a tile that is already built
+    Style* restyle = nullptr;
+
+    // Number of the restyle of <restyle> this task belongs to, see TileManager::restyle
+    int restyleGeneration = 0;
+
+    // Position of this task in the <TileTaskQueue> holding it
+    size_t queueIndex = TileTaskQueue::NOT_QUEUED;
+
+    // Time at which the data arrived, see <TileTiming>
+    double receivedTime;
 
     TileTask(std::vector<char>&& _rawTileData, const TileID& _tileID, DataSource* _source) :
         tileID(_tileID),
         rawTileData(std::move(_rawTileData)),
-        source(_source) {
+        source(_source),
+        receivedTime(TileTiming::now()) {
     }
 
     TileTask(std::shared_ptr<TileData>& _tileData, const TileID& _tileID, DataSource* _source) :
         tileID(_tileID),
         parsedTileData(_tileData),
-        source(_source) {       
+        source(_source),
+        receivedTime(TileTiming::now()) {
     }
 
-    TileTask(TileTask&& _other) :
-        tileID(_other.tileID),
-        parsedTileData(std::move(_other.parsedTileData)),
-        rawTileData(std::move(_other.rawTileData)),
-        source(std::move(_other.source)) {
-    }
+};
 
+/* Geometry of one <Style> rebuilt for a tile that is already built, see TileManager::restyle */
+struct RestyledTile {
+    std::shared_ptr<MapTile> tile; // Holds only the geometry, text buffer and labels of the style
+    Style* style;
+    int generation; // See TileTask::restyleGeneration
 };
 
+/* Builds <MapTile>s from <TileTask>s on a persistent pool of threads
+ *
+ * Tasks wait in a priority queue until a worker thread picks them up; idle threads always take the
+ * most urgent task, regardless of the order in which tasks were enqueued. Finished tiles are collected
+ * in a completion queue which the main thread drains with <takeFinishedTiles>
+ */
 class TileWorker {
-    
+
 public:
-    
-    TileWorker();
-    
-    void processTileData(std::unique_ptr<TileTask> _task,
-                         const std::vector<std::unique_ptr<Style>>& _styles,
-                         const View& _view);
-    
-    void abort();
-    
-    bool isFinished() const { return m_finished; }
-
-    bool isFree() const { return m_free; }
-    
-    const TileID& getTileID() const { return m_task->tileID; }
-    
-    std::shared_ptr<MapTile> getTileResult();
-    
+
+    TileWorker(size_t _numThreads = ThreadPool::defaultThreadCount());
+
+    /* Cancels all pending tasks and waits for the worker threads to finish */
+    ~TileWorker();
+
+    /* Queues @_task to be parsed (if needed) and styled with the styles of @_scene */
+    void enqueue(std::shared_ptr<TileTask> _task, std::shared_ptr<Scene> _scene, std::shared_ptr<View> _view);
+
+    /* Cancels all pending tasks for @_tileID; tiles of canceled tasks are never reported as finished */
+    void cancel(const TileID& _tileID);
+
+    /* Sets the priority of current and future tasks for @_tileID; it is kept until the tile is canceled */
+    void setPriority(const TileID& _tileID, float _priority);
+
+    /* Recomputes the priorities of all tiles passed to <setPriority> using @_priority and reorders the queue */
+    void updatePriorities(const std::function<float(const TileID&)>& _priority);
+
+    /* Sets whether tasks for @_tileID enqueued from now on only parse the tile data without building the tile */
+    void setParseOnly(const TileID& _tileID, bool _parseOnly);
+
+    /* Moves all tiles finished since the last call into @_tiles */
+    void takeFinishedTiles(std::vector<std::shared_ptr<MapTile>>& _tiles);
+
+    /* Moves the results of all restyle tasks finished since the last call into @_tiles */
+    void takeRestyledTiles(std::vector<RestyledTile>& _tiles);
+
+    /* Replaces the worker threads by a pool of @_numThreads threads; queued tasks move to the new
+     * threads, and this blocks only until the tasks in progress on the previous threads are done */
+    void setNumThreads(size_t _numThreads);
+
+    size_t getNumThreads();
+
 private:
-    
-    bool m_free;
-    bool m_aborted;
-    bool m_finished;
-    
-    std::unique_ptr<TileTask> m_task;
-    std::future< std::shared_ptr<MapTile> > m_future;
-};
 
+    /* Adds a job to @_pool that processes the most urgent queued task; a job whose pool was replaced
+     * meanwhile is posted to the current pool instead */
+    void post(ThreadPool& _pool, std::shared_ptr<Scene> _scene, std::shared_ptr<View> _view);
+
+    void process(std::shared_ptr<TileTask> _task, const Scene& _scene, const View& _view);
+
+    /* Adds the geometry of @_styles for @_data to @_tile; styles are built concurrently on the thread pool,
+     * each into a tile of its own, and merged into @_tile once all of them are done */
+    void buildStyles(const std::vector<Style*>& _styles, const TileData& _data, MapTile& _tile,
+                     const TileTask& _task, const View& _view);
+
+    /* Returns the parsed data of @_dataID if @_source has it, waiting while another task parses it; otherwise
+     * marks the data as being parsed by the caller, which must call <endParse> once it is done */
+    std::shared_ptr<TileData> beginParse(DataSource* _source, const TileID& _dataID);
+
+    void endParse(DataSource* _source, const TileID& _dataID);
+
+    /* Takes the most urgent queued task, or returns nullptr if there is none */
+    std::shared_ptr<TileTask> next();
+
+    /* Removes a task from m_tasks once it is finished or canceled */
+    void release(const std::shared_ptr<TileTask>& _task);
+
+    std::mutex m_taskMutex; // Guards m_tasks, m_queue, m_priorities and m_parseOnly
+    std::multimap<TileID, std::shared_ptr<TileTask>> m_tasks; // Tasks queued or in progress
+    TileTaskQueue m_queue; // Tasks not yet picked up by a worker thread
+    std::map<TileID, float> m_priorities;
+    std::set<TileID> m_parseOnly;
+
+    // Data being parsed, so that tasks with the same data, e.g. overzoomed siblings, parse it only once
+    std::mutex m_parseMutex;
+    std::condition_variable m_parseDone;
+    std::set<std::pair<DataSource*, TileID>> m_parsing;
+
+    std::mutex m_finishedMutex;
+    std::vector<std::shared_ptr<MapTile>> m_finishedTiles;
+    std::vector<RestyledTile> m_restyledTiles;
+
+    std::mutex m_poolMutex;
+    std::shared_ptr<ThreadPool> m_pool;
+
+};
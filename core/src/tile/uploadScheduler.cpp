@@ -0,0 +1,70 @@
+#include "uploadScheduler.h"
+#include "mapTile.h"
+
+#include <algorithm>
+
+const size_t UploadScheduler::s_defaultBudget;
+
+void UploadScheduler::add(const std::shared_ptr<MapTile>& _tile) {
+
+    for (const auto& tile : m_tiles) {
+        if (tile.lock() == _tile) {
+            return;
+        }
+    }
+
+    m_tiles.push_back(_tile);
+
+}
+
+void UploadScheduler::update(const std::function<float(const TileID&)>& _priority, std::vector<std::shared_ptr<MapTile>>& _uploaded) {
+
+    std::vector<std::pair<float, std::shared_ptr<MapTile>>> tiles;
+    tiles.reserve(m_tiles.size());
+
+    for (const auto& weakTile : m_tiles) {
+        auto tile = weakTile.lock();
+        if (tile) {
+            tiles.emplace_back(_priority(tile->getID()), std::move(tile));
+        }
+    }
+
+    std::sort(tiles.begin(), tiles.end(), [](const std::pair<float, std::shared_ptr<MapTile>>& _a,
+                                             const std::pair<float, std::shared_ptr<MapTile>>& _b) {
+        return _a.first < _b.first;
+    });
+
+    m_tiles.clear();
+
+    size_t uploaded = 0;
+
+    for (auto& entry : tiles) {
+        auto& tile = entry.second;
+
+        if (uploaded < m_budget || uploaded == 0) {
+            // A tile always gets at least one mesh uploaded when nothing was uploaded yet
+            uploaded += tile->uploadMeshes(uploaded < m_budget ? m_budget - uploaded : 0);
+        }
+
+        if (tile->hasPendingUploads()) {
+            m_tiles.push_back(tile);
+        } else {
+            _uploaded.push_back(std::move(tile));
+        }
+    }
+
+}
+
+size_t UploadScheduler::getPendingBytes() const {
+
+    size_t bytes = 0;
+
+    for (const auto& weakTile : m_tiles) {
+        auto tile = weakTile.lock();
+        if (tile) {
+            bytes += tile->getPendingUploadBytes();
+        }
+    }
+
+    return bytes;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "util/tileID.h"
+
+class MapTile;
+
+/* Spreads the upload of tile meshes to the GPU over several frames
+ *
+ * Built tiles are registered with <add> instead of uploading all of their meshes the first time they
+ * are drawn. Each call to <update> uploads meshes of the registered tiles, most urgent tiles first,
+ * until a budget of bytes per frame is spent; at least one mesh is uploaded per call so that meshes
+ * larger than the budget still make progress. Only used from the thread owning the GL context.
+ */
+class UploadScheduler {
+
+public:
+
+    /* Registers @_tile to have its meshes uploaded; tiles are dropped once uploaded or released */
+    void add(const std::shared_ptr<MapTile>& _tile);
+
+    /* Uploads meshes of registered tiles in order of @_priority (lower values first) until the budget
+     * is spent; tiles whose meshes are all uploaded are moved into @_uploaded */
+    void update(const std::function<float(const TileID&)>& _priority, std::vector<std::shared_ptr<MapTile>>& _uploaded);
+
+    /* Sets the number of bytes of vertex and index data uploaded per frame */
+    void setBudget(size_t _bytes) { m_budget = _bytes; }
+
+    size_t getBudget() const { return m_budget; }
+
+    /* Returns the number of bytes of mesh data of registered tiles that are not uploaded yet */
+    size_t getPendingBytes() const;
+
+    void clear() { m_tiles.clear(); }
+
+    static const size_t s_defaultBudget = 1024 * 1024;
+
+private:
+
+    std::vector<std::weak_ptr<MapTile>> m_tiles;
+
+    size_t m_budget = s_defaultBudget;
+
+};
@@ -0,0 +1,72 @@
+#include "bufferPool.h"
+
+#include <utility>
+
+std::vector<char> BufferPool::acquire(size_t _capacity) {
+
+    std::vector<char> buffer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_buffers.empty()) {
+
+            // Prefer the smallest buffer that is large enough, otherwise take the largest one
+            auto best = m_buffers.end();
+            auto largest = m_buffers.begin();
+
+            for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+                if (it->capacity() >= _capacity && (best == m_buffers.end() || it->capacity() < best->capacity())) {
+                    best = it;
+                }
+                if (it->capacity() > largest->capacity()) {
+                    largest = it;
+                }
+            }
+
+            std::swap(best != m_buffers.end() ? *best : *largest, m_buffers.back());
+            buffer = std::move(m_buffers.back());
+            m_buffers.pop_back();
+        }
+    }
+
+    buffer.reserve(_capacity);
+
+    return buffer;
+}
+
+void BufferPool::release(std::vector<char>&& _buffer) {
+
+    if (_buffer.capacity() == 0 || _buffer.capacity() > s_maxBufferSize) {
+        return;
+    }
+
+    _buffer.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_buffers.size() < s_maxBuffers) {
+        m_buffers.push_back(std::move(_buffer));
+    }
+
+}
+
+void BufferPool::clear() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_buffers.clear();
+
+}
+
+size_t BufferPool::getPooledBytes() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t bytes = 0;
+    for (const auto& buffer : m_buffers) {
+        bytes += buffer.capacity();
+    }
+
+    return bytes;
+}
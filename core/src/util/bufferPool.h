@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/* Pool of byte buffers for raw tile data
+ *
+ * Network responses and cached tile data are written into buffers taken from the pool and released
+ * back to it once the data is parsed, so that the memory of large responses is reused instead of being
+ * allocated and grown again for every tile. The pool keeps at most <s_maxBuffers> buffers and drops
+ * buffers larger than <s_maxBufferSize>. Safe to use from any thread.
+ */
+class BufferPool {
+
+public:
+
+    static BufferPool& GetInstance() {
+        static BufferPool instance;
+        return instance;
+    }
+
+    /* Returns an empty buffer with a capacity of at least @_capacity bytes */
+    std::vector<char> acquire(size_t _capacity = 0);
+
+    /* Returns @_buffer to the pool; its content is discarded */
+    void release(std::vector<char>&& _buffer);
+
+    /* Drops all pooled buffers */
+    void clear();
+
+    /* Returns the total capacity of the pooled buffers in bytes */
+    size_t getPooledBytes();
+
+    static const size_t s_maxBuffers = 16;
+    static const size_t s_maxBufferSize = 4 * 1024 * 1024;
+
+private:
+
+    BufferPool() {}
+
+    std::mutex m_mutex;
+    std::vector<std::vector<char>> m_buffers;
+
+};
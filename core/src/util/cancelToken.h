@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/* Cancellation flag shared between the owner of a task and the thread running it
+ *
+ * Long-running operations (parsing, styling) take a CancelToken and poll it at regular intervals,
+ * returning early with partial results once it is canceled. Callers must discard the results of
+ * an operation whose token was canceled.
+ */
+class CancelToken {
+
+public:
+
+    CancelToken() : m_canceled(false) {}
+
+    CancelToken(const CancelToken&) = delete;
+    CancelToken& operator=(const CancelToken&) = delete;
+
+    /* Requests that operations polling this token stop; safe to call from any thread */
+    void cancel() { m_canceled.store(true, std::memory_order_relaxed); }
+
+    bool isCanceled() const { return m_canceled.load(std::memory_order_relaxed); }
+
+    /* Returns true if the token is canceled, polling it only for every <s_batchSize>th @_index */
+    bool isCanceled(size_t _index) const { return _index % s_batchSize == 0 && isCanceled(); }
+
+    /* Returns a token that is never canceled, for operations that cannot be aborted */
+    static const CancelToken& none() {
+        static const CancelToken token;
+        return token;
+    }
+
+    // Number of features processed between two checks of the token in per-feature loops
+    static const size_t s_batchSize = 32;
+
+private:
+
+    std::atomic<bool> m_canceled;
+
+};
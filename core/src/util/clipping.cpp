@@ -0,0 +1,277 @@
+#include "clipping.h"
+#include "geom.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Clipping {
+
+namespace {
+
+    Point lerp(const Point& _a, const Point& _b, float _t) {
+        return _a + (_b - _a) * _t;
+    }
+
+    /* Clips the segment from @_a to @_b to @_bounds (Liang-Barsky); on success the visible part is
+     * the range [@_t0, @_t1] of the segment parameter */
+    bool clipSegment(const Point& _a, const Point& _b, const glm::vec4& _bounds, float& _t0, float& _t1) {
+
+        float dx = _b.x - _a.x;
+        float dy = _b.y - _a.y;
+
+        const float p[4] = { -dx, dx, -dy, dy };
+        const float q[4] = { _a.x - _bounds.x, _bounds.z - _a.x, _a.y - _bounds.y, _bounds.w - _a.y };
+
+        _t0 = 0.f;
+        _t1 = 1.f;
+
+        for (int i = 0; i < 4; i++) {
+            if (p[i] == 0.f) {
+                if (q[i] < 0.f) { return false; } // Parallel to and outside of this edge
+                continue;
+            }
+            float t = q[i] / p[i];
+            if (p[i] < 0.f) {
+                if (t > _t1) { return false; }
+                if (t > _t0) { _t0 = t; }
+            } else {
+                if (t < _t0) { return false; }
+                if (t < _t1) { _t1 = t; }
+            }
+        }
+
+        return true;
+    }
+
+    /* Signed distance of @_point inside the edge @_edge of @_bounds (0: xmin, 1: ymin, 2: xmax, 3: ymax) */
+    float insideDistance(const Point& _point, const glm::vec4& _bounds, int _edge) {
+        switch (_edge) {
+            case 0: return _point.x - _bounds.x;
+            case 1: return _point.y - _bounds.y;
+            case 2: return _bounds.z - _point.x;
+            default: return _bounds.w - _point.y;
+        }
+    }
+
+    /* Clips a ring against one edge of @_bounds, treating it as closed (Sutherland-Hodgman) */
+    void clipRingEdge(const Line& _ring, const glm::vec4& _bounds, int _edge, Line& _out) {
+
+        _out.clear();
+
+        if (_ring.empty()) {
+            return;
+        }
+
+        const Point* prev = &_ring.back();
+        float prevDist = insideDistance(*prev, _bounds, _edge);
+
+        for (const auto& point : _ring) {
+            float dist = insideDistance(point, _bounds, _edge);
+
+            if (dist >= 0.f) {
+                if (prevDist < 0.f) {
+                    _out.push_back(lerp(*prev, point, prevDist / (prevDist - dist)));
+                }
+                _out.push_back(point);
+            } else if (prevDist >= 0.f) {
+                _out.push_back(lerp(*prev, point, prevDist / (prevDist - dist)));
+            }
+
+            prev = &point;
+            prevDist = dist;
+        }
+    }
+
+    /* Clips a polygon ring to @_bounds; returns false if less than a triangle is left */
+    bool clipRing(const Line& _ring, const glm::vec4& _bounds, Line& _out) {
+
+        bool closed = _ring.size() > 1 && _ring.front() == _ring.back();
+
+        Line input(_ring.begin(), closed ? _ring.end() - 1 : _ring.end());
+        Line output;
+
+        for (int edge = 0; edge < 4; edge++) {
+            clipRingEdge(input, _bounds, edge, output);
+            std::swap(input, output);
+        }
+
+        if (input.size() < 3) {
+            return false;
+        }
+
+        if (closed) {
+            input.push_back(input.front());
+        }
+
+        _out = std::move(input);
+        return true;
+    }
+
+}
+
+glm::vec4 getTileBounds(float _buffer) {
+
+    // A tile is 2 units wide
+    float extent = 1.f + 2.f * _buffer;
+    return glm::vec4(-extent, -extent, extent, extent);
+}
+
+glm::vec4 getBounds(const Line& _line) {
+
+    // Independent min and max accumulators, without branches, so the loop can be vectorized
+    float minX = std::numeric_limits<float>::max(), minY = minX;
+    float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+
+    for (const auto& point : _line) {
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+
+    return glm::vec4(minX, minY, maxX, maxY);
+}
+
+Overlap getOverlap(const Line& _line, const glm::vec4& _bounds) {
+
+    glm::vec4 box = getBounds(_line);
+
+    if (box.x >= _bounds.x && box.y >= _bounds.y && box.z <= _bounds.z && box.w <= _bounds.w) {
+        return Overlap::inside;
+    }
+    if (box.z < _bounds.x || box.w < _bounds.y || box.x > _bounds.z || box.y > _bounds.w) {
+        return Overlap::outside;
+    }
+    return Overlap::partial;
+}
+
+Overlap getOverlap(const Polygon& _polygon, const glm::vec4& _bounds) {
+
+    // A multipolygon may have outer rings on either side of the bounds
+    bool inside = true, outside = true;
+
+    for (const auto& ring : _polygon) {
+        switch (getOverlap(ring, _bounds)) {
+            case Overlap::inside: outside = false; break;
+            case Overlap::outside: inside = false; break;
+            case Overlap::partial: return Overlap::partial;
+        }
+    }
+
+    if (inside) { return Overlap::inside; }
+    if (outside) { return Overlap::outside; }
+    return Overlap::partial;
+}
+
+bool containsPoint(const glm::vec4& _bounds, const Point& _point) {
+    return _point.x >= _bounds.x && _point.x <= _bounds.z && _point.y >= _bounds.y && _point.y <= _bounds.w;
+}
+
+void clipLine(const Line& _line, const glm::vec4& _bounds, std::vector<Line>& _out) {
+
+    Line current;
+
+    for (size_t i = 0; i + 1 < _line.size(); i++) {
+
+        float t0, t1;
+
+        if (!clipSegment(_line[i], _line[i + 1], _bounds, t0, t1)) {
+            if (current.size() > 1) { _out.push_back(std::move(current)); }
+            current.clear();
+            continue;
+        }
+
+        if (current.empty()) {
+            current.push_back(lerp(_line[i], _line[i + 1], t0));
+        }
+        current.push_back(lerp(_line[i], _line[i + 1], t1));
+
+        if (t1 < 1.f) {
+            // The line leaves the bounds in this segment
+            if (current.size() > 1) { _out.push_back(std::move(current)); }
+            current.clear();
+        }
+    }
+
+    if (current.size() > 1) {
+        _out.push_back(std::move(current));
+    }
+}
+
+void clipPolygon(const Polygon& _polygon, const glm::vec4& _bounds, Polygon& _out) {
+
+    _out.clear();
+
+    if (_polygon.empty()) {
+        return;
+    }
+
+    int outerSign = signValue(signedArea(_polygon.front()));
+    bool keepHoles = false;
+
+    for (const auto& ring : _polygon) {
+        Line clipped;
+        if (signValue(signedArea(ring)) == outerSign) {
+            keepHoles = clipRing(ring, _bounds, clipped);
+            if (keepHoles) {
+                _out.push_back(std::move(clipped));
+            }
+        } else if (keepHoles && clipRing(ring, _bounds, clipped)) {
+            _out.push_back(std::move(clipped));
+        }
+    }
+}
+
+bool clipFeature(const Feature& _feature, const glm::vec4& _bounds, Feature& _out) {
+
+    _out = _feature;
+    return clipFeature(_out, _bounds);
+}
+
+bool clipFeature(Feature& _feature, const glm::vec4& _bounds) {
+
+    auto isOutside = [&](const Point& _point) { return !containsPoint(_bounds, _point); };
+    _feature.points.erase(std::remove_if(_feature.points.begin(), _feature.points.end(), isOutside), _feature.points.end());
+
+    // Geometry inside the bounds, usually most of it, is kept without copying
+    std::vector<Line> lines;
+
+    for (auto& line : _feature.lines) {
+        switch (getOverlap(line, _bounds)) {
+            case Overlap::inside: lines.push_back(std::move(line)); break;
+            case Overlap::partial: clipLine(line, _bounds, lines); break;
+            case Overlap::outside: break;
+        }
+    }
+
+    _feature.lines = std::move(lines);
+
+    std::vector<Polygon> polygons;
+
+    for (auto& polygon : _feature.polygons) {
+        if (polygon.empty()) {
+            continue;
+        }
+        switch (getOverlap(polygon, _bounds)) {
+            case Overlap::inside:
+                polygons.push_back(std::move(polygon));
+                break;
+            case Overlap::partial: {
+                Polygon clipped;
+                clipPolygon(polygon, _bounds, clipped);
+                if (!clipped.empty()) {
+                    polygons.push_back(std::move(clipped));
+                }
+                break;
+            }
+            case Overlap::outside:
+                break;
+        }
+    }
+
+    _feature.polygons = std::move(polygons);
+
+    return !(_feature.points.empty() && _feature.lines.empty() && _feature.polygons.empty());
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/vec4.hpp"
+#include "data/tileData.h"
+
+/* Clipping of tile geometry to axis-aligned rectangles
+ *
+ * Bounds are given as (xmin, ymin, xmax, ymax) in the coordinates of the geometry. Lines are split
+ * where they leave the bounds; polygon rings are clipped with the Sutherland-Hodgman algorithm, so
+ * that clipped polygons stay closed along the bounds.
+ */
+namespace Clipping {
+
+    /* How a line or ring lies relative to some bounds, judged by its bounding box */
+    enum class Overlap { inside, outside, partial };
+
+    /* Returns the bounds of a tile, whose coordinates span [-1, 1], grown on each side by @_buffer as a
+     * fraction of the tile size */
+    glm::vec4 getTileBounds(float _buffer);
+
+    /* Returns the bounding box of @_line as (xmin, ymin, xmax, ymax) */
+    glm::vec4 getBounds(const Line& _line);
+
+    Overlap getOverlap(const Line& _line, const glm::vec4& _bounds);
+
+    /* How the rings of @_polygon, all of them, lie relative to some bounds */
+    Overlap getOverlap(const Polygon& _polygon, const glm::vec4& _bounds);
+
+    bool containsPoint(const glm::vec4& _bounds, const Point& _point);
+
+    /* Appends the parts of @_line inside @_bounds to @_out */
+    void clipLine(const Line& _line, const glm::vec4& _bounds, std::vector<Line>& _out);
+
+    /* Clips the rings of @_polygon to @_bounds into @_out, each on its own; rings wound like the first
+     * one are outer rings, each followed by its holes, as in the multipolygons of vector tiles. Rings
+     * outside the bounds are dropped, and the holes of a dropped outer ring with it */
+    void clipPolygon(const Polygon& _polygon, const glm::vec4& _bounds, Polygon& _out);
+
+    /* Clips the geometry of @_feature to @_bounds into @_out, which also receives its properties;
+     * returns false if no geometry is left */
+    bool clipFeature(const Feature& _feature, const glm::vec4& _bounds, Feature& _out);
+
+    /* Clips the geometry of @_feature to @_bounds in place; lines and polygons entirely inside the bounds
+     * are kept as they are. Returns false if no geometry is left */
+    bool clipFeature(Feature& _feature, const glm::vec4& _bounds);
+
+}
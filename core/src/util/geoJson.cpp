@@ -28,38 +28,42 @@ void GeoJson::extractPoly(const rapidjson::Value& _in, Polygon& _out, const MapT
     
 }
 
-void GeoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile) {
-    
-    // Copy properties into tile data
+void GeoJson::extractProperties(const rapidjson::Value& _in, Properties& _out, const MapTile& _tile) {
     
-    const rapidjson::Value& properties = _in["properties"];
-    
-    for (auto itr = properties.MemberBegin(); itr != properties.MemberEnd(); ++itr) {
+    for (auto itr = _in.MemberBegin(); itr != _in.MemberEnd(); ++itr) {
         
         const auto& member = itr->name.GetString();
         
-        const rapidjson::Value& prop = properties[member];
+        const rapidjson::Value& prop = itr->value;
         
         // height and minheight need to be handled separately so that their dimensions are normalized
         if (strcmp(member, "height") == 0) {
-            _out.props.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
+            _out.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
             continue;
         }
         
         if (strcmp(member, "min_height") == 0) {
-            _out.props.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
+            _out.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
             continue;
         }
         
         
         if (prop.IsNumber()) {
-            _out.props.numericProps[member] = prop.GetDouble();
+            _out.numericProps[member] = prop.GetDouble();
         } else if (prop.IsString()) {
-            _out.props.stringProps[member] = prop.GetString();
+            _out.stringProps[member] = prop.GetString();
         }
         
     }
     
+}
+
+void GeoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile) {
+    
+    // Copy properties into tile data
+    
+    extractProperties(_in["properties"], _out.props, _tile);
+    
     // Copy geometry into tile data
     
     const rapidjson::Value& geometry = _in["geometry"];
@@ -110,7 +114,7 @@ void GeoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const M
     
 }
 
-void GeoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTile& _tile) {
+void GeoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTile& _tile, const CancelToken& _cancel) {
     
     const auto& featureIter = _in.FindMember("features");
     
@@ -120,7 +124,11 @@ void GeoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTi
     }
     
     const auto& features = featureIter->value;
+    size_t featureIndex = 0;
     for (auto featureJson = features.Begin(); featureJson != features.End(); ++featureJson) {
+        if (_cancel.isCanceled(++featureIndex)) {
+            return;
+        }
         _out.features.emplace_back();
         extractFeature(*featureJson, _out.features.back(), _tile);
     }
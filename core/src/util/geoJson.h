@@ -6,6 +6,7 @@
 
 #include "mapTile.h"
 #include "tileData.h"
+#include "util/cancelToken.h"
 
 namespace GeoJson {
     
@@ -15,9 +16,13 @@ namespace GeoJson {
     
     void extractPoly(const rapidjson::Value& _in, Polygon& _out, const MapTile& _tile);
     
+    /* Copies the members of the JSON object @_in into @_out; heights are scaled to tile units */
+    void extractProperties(const rapidjson::Value& _in, Properties& _out, const MapTile& _tile);
+    
     void extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile);
     
-    void extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTile& _tile);
+    /* Extracts the features of @_in into @_out; stops early once @_cancel is canceled */
+    void extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTile& _tile, const CancelToken& _cancel = CancelToken::none());
     
 }
 
@@ -0,0 +1,296 @@
+#include "geoJsonReader.h"
+#include "util/clipping.h"
+#include "util/mapProjection.h"
+
+#include <cstring>
+
+GeoJsonReader::GeoJsonReader(TileData& _out, const MapTile& _tile, const CancelToken& _cancel, const std::string& _layerName,
+                             float _clipBuffer) :
+    m_out(_out), m_tile(_tile), m_cancel(_cancel), m_layerName(_layerName), m_clipBuffer(_clipBuffer) {
+}
+
+bool GeoJsonReader::Key(const char* _str, rapidjson::SizeType _length, bool _copy) {
+
+    if (m_skipDepth == 0) {
+        m_key.assign(_str, _length);
+    }
+
+    return true;
+}
+
+bool GeoJsonReader::String(const char* _str, rapidjson::SizeType _length, bool _copy) {
+
+    if (m_skipDepth > 0 || m_states.empty()) {
+        return true;
+    }
+
+    switch (m_states.back()) {
+        case State::geometry:
+            if (m_key == "type") {
+                if (std::strcmp(_str, "Point") == 0) { m_geometry = Geometry::point; }
+                else if (std::strcmp(_str, "MultiPoint") == 0) { m_geometry = Geometry::multiPoint; }
+                else if (std::strcmp(_str, "LineString") == 0) { m_geometry = Geometry::lineString; }
+                else if (std::strcmp(_str, "MultiLineString") == 0) { m_geometry = Geometry::multiLineString; }
+                else if (std::strcmp(_str, "Polygon") == 0) { m_geometry = Geometry::polygon; }
+                else if (std::strcmp(_str, "MultiPolygon") == 0) { m_geometry = Geometry::multiPolygon; }
+            }
+            break;
+        case State::properties:
+            m_out.layers.back().features.back().props.stringProps[m_key].assign(_str, _length);
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool GeoJsonReader::number(double _value) {
+
+    if (m_skipDepth > 0 || m_states.empty()) {
+        return true;
+    }
+
+    switch (m_states.back()) {
+        case State::coordinates:
+            // Altitudes are ignored
+            if (m_positionSize < 2) {
+                m_position[m_positionSize] = _value;
+            }
+            m_positionSize++;
+            break;
+        case State::properties: {
+            Properties& props = m_out.layers.back().features.back().props;
+            // height and minheight need to be handled separately so that their dimensions are normalized
+            if (m_key == "height" || m_key == "min_height") {
+                props.numericProps[m_key] = _value * m_tile.getInverseScale();
+            } else {
+                props.numericProps[m_key] = _value;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool GeoJsonReader::StartObject() {
+
+    if (m_skipDepth > 0) {
+        m_skipDepth++;
+        return true;
+    }
+
+    if (m_states.empty()) {
+        m_states.push_back(State::root);
+        return true;
+    }
+
+    switch (m_states.back()) {
+        case State::root:
+            m_out.layers.emplace_back(m_key);
+            m_states.push_back(State::layer);
+            return true;
+        case State::features:
+            startFeature();
+            m_states.push_back(State::feature);
+            return true;
+        case State::feature:
+            if (m_key == "geometry") {
+                m_states.push_back(State::geometry);
+                return true;
+            }
+            if (m_key == "properties") {
+                m_states.push_back(State::properties);
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+
+    m_skipDepth = 1;
+
+    return true;
+}
+
+bool GeoJsonReader::EndObject(rapidjson::SizeType _memberCount) {
+
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
+    }
+
+    State state = m_states.back();
+    m_states.pop_back();
+
+    if (state == State::feature) {
+
+        Layer& layer = m_out.layers.back();
+        if (!finishFeature()) {
+            layer.features.pop_back();
+        } else if (m_clipBuffer >= 0) {
+            if (!Clipping::clipFeature(layer.features.back(), Clipping::getTileBounds(m_clipBuffer))) {
+                layer.features.pop_back();
+            }
+        }
+
+        // Returning false stops the reader
+        return !m_cancel.isCanceled(++m_featureIndex);
+    }
+
+    return true;
+}
+
+bool GeoJsonReader::StartArray() {
+
+    if (m_skipDepth > 0) {
+        m_skipDepth++;
+        return true;
+    }
+
+    if (!m_states.empty()) {
+        switch (m_states.back()) {
+            case State::root:
+                if (m_key == "features") {
+                    // The document is a single feature collection
+                    m_out.layers.emplace_back(m_layerName);
+                    m_states.push_back(State::features);
+                    return true;
+                }
+                break;
+            case State::layer:
+                if (m_key == "features") {
+                    m_states.push_back(State::features);
+                    return true;
+                }
+                break;
+            case State::geometry:
+                if (m_key == "coordinates") {
+                    m_states.push_back(State::coordinates);
+                    m_coordinateDepth = 1;
+                    m_positionSize = 0;
+                    return true;
+                }
+                break;
+            case State::coordinates:
+                m_coordinateDepth++;
+                m_positionSize = 0;
+                return true;
+            default:
+                break;
+        }
+    }
+
+    m_skipDepth = 1;
+
+    return true;
+}
+
+bool GeoJsonReader::EndArray(rapidjson::SizeType _elementCount) {
+
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
+    }
+
+    State state = m_states.back();
+
+    if (state == State::coordinates) {
+
+        if (m_positionSize >= 2) {
+            // An array of numbers is a position
+            glm::dvec2 meters = m_tile.getProjection()->LonLatToMeters(glm::dvec2(m_position[0], m_position[1]));
+            m_points.emplace_back((meters.x - m_tile.getOrigin().x) * m_tile.getInverseScale(),
+                                  (meters.y - m_tile.getOrigin().y) * m_tile.getInverseScale(), 0.f);
+            m_positionDepth = m_coordinateDepth;
+            m_positionSize = 0;
+        } else {
+            m_arrayEnds.push_back({ m_coordinateDepth, m_points.size() });
+        }
+
+        if (--m_coordinateDepth > 0) {
+            return true;
+        }
+    }
+
+    m_states.pop_back();
+
+    return true;
+}
+
+void GeoJsonReader::startFeature() {
+
+    m_out.layers.back().features.emplace_back();
+
+    m_geometry = Geometry::unknown;
+    m_points.clear();
+    m_arrayEnds.clear();
+    m_coordinateDepth = 0;
+    m_positionDepth = 0;
+    m_positionSize = 0;
+
+}
+
+bool GeoJsonReader::finishFeature() {
+
+    Feature& feature = m_out.layers.back().features.back();
+
+    // Nesting level of positions in the coordinates of each geometry type
+    int expectedDepth = 0;
+
+    switch (m_geometry) {
+        case Geometry::point: expectedDepth = 1; break;
+        case Geometry::multiPoint: case Geometry::lineString: expectedDepth = 2; break;
+        case Geometry::multiLineString: case Geometry::polygon: expectedDepth = 3; break;
+        case Geometry::multiPolygon: expectedDepth = 4; break;
+        case Geometry::unknown: return false;
+    }
+
+    if (m_points.empty()) {
+        // Empty geometries are valid, but there is nothing to draw
+        return false;
+    }
+
+    if (m_positionDepth != expectedDepth) {
+        return false;
+    }
+
+    if (m_geometry == Geometry::point || m_geometry == Geometry::multiPoint) {
+        feature.geometryType = GeometryType::POINTS;
+        feature.points = m_points;
+        return true;
+    }
+
+    bool polygons = m_geometry == Geometry::polygon || m_geometry == Geometry::multiPolygon;
+    feature.geometryType = polygons ? GeometryType::POLYGONS : GeometryType::LINES;
+
+    // Lines and rings are the arrays that contain positions; in multipolygons, the arrays that contain
+    // rings end each polygon
+    int lineDepth = m_positionDepth - 1;
+    size_t start = 0;
+    Polygon polygon;
+
+    for (const auto& end : m_arrayEnds) {
+        if (end.depth == lineDepth) {
+            Line line(m_points.begin() + start, m_points.begin() + end.points);
+            start = end.points;
+            if (polygons) {
+                polygon.push_back(std::move(line));
+            } else {
+                feature.lines.push_back(std::move(line));
+            }
+        } else if (end.depth == lineDepth - 1 && m_geometry == Geometry::multiPolygon) {
+            feature.polygons.push_back(std::move(polygon));
+            polygon.clear();
+        }
+    }
+
+    if (m_geometry == Geometry::polygon) {
+        feature.polygons.push_back(std::move(polygon));
+    }
+
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rapidjson/reader.h"
+
+#include "mapTile.h"
+#include "tileData.h"
+#include "util/cancelToken.h"
+
+/* Streaming reader of GeoJSON tiles
+ *
+ * Handles the events of a rapidjson::Reader for a tile whose members are layers, each a feature
+ * collection, or for a single feature collection, and adds the features to a <TileData> as they are
+ * read, so that no document of the whole tile is built. Coordinates are projected to tile coordinates
+ * as they are read; members that are not needed are skipped. Reading stops, and the reader returns an
+ * error, once the cancel token is canceled.
+ */
+class GeoJsonReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, GeoJsonReader> {
+
+public:
+
+    /* Reads features into @_out, in the coordinates of @_tile; the features of a document that is a
+     * single feature collection are added to a layer named @_layerName. With a @_clipBuffer of zero or
+     * more, geometry is clipped to the tile extended by that fraction of its size */
+    GeoJsonReader(TileData& _out, const MapTile& _tile, const CancelToken& _cancel, const std::string& _layerName = "",
+                  float _clipBuffer = -1.f);
+
+    /* Handler interface of rapidjson::Reader */
+    bool Null() { return true; }
+    bool Bool(bool) { return true; }
+    bool Int(int _value) { return number(_value); }
+    bool Uint(unsigned _value) { return number(_value); }
+    bool Int64(int64_t _value) { return number(_value); }
+    bool Uint64(uint64_t _value) { return number(_value); }
+    bool Double(double _value) { return number(_value); }
+    bool String(const char* _str, rapidjson::SizeType _length, bool _copy);
+    bool Key(const char* _str, rapidjson::SizeType _length, bool _copy);
+    bool StartObject();
+    bool EndObject(rapidjson::SizeType _memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType _elementCount);
+
+private:
+
+    /* JSON value that is being read */
+    enum class State {
+        root,           // Object of layers, or a feature collection
+        layer,          // Feature collection
+        features,       // Array of features of a layer
+        feature,
+        geometry,
+        coordinates,    // Nested arrays of coordinates of a geometry
+        properties
+    };
+
+    enum class Geometry {
+        unknown,
+        point,
+        multiPoint,
+        lineString,
+        multiLineString,
+        polygon,
+        multiPolygon
+    };
+
+    /* End of an array of coordinates at nesting level @depth, after @points positions */
+    struct ArrayEnd {
+        int depth;
+        size_t points;
+    };
+
+    bool number(double _value);
+
+    void startFeature();
+
+    /* Builds the geometry of the current feature from the coordinates read; returns false if the
+     * coordinates don't match the geometry type */
+    bool finishFeature();
+
+    TileData& m_out;
+    const MapTile& m_tile;
+    const CancelToken& m_cancel;
+    std::string m_layerName;
+    float m_clipBuffer;
+
+    std::vector<State> m_states;
+    int m_skipDepth = 0; // Nesting level inside a value that is skipped
+    std::string m_key;
+
+    size_t m_featureIndex = 0;
+
+    // Geometry of the current feature
+    Geometry m_geometry = Geometry::unknown;
+    std::vector<Point> m_points;
+    std::vector<ArrayEnd> m_arrayEnds;
+    int m_coordinateDepth = 0;
+    int m_positionDepth = 0;
+    double m_position[2];
+    int m_positionSize = 0;
+
+};
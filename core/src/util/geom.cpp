@@ -7,6 +7,19 @@ int signValue(float _n) {
     else return 0;
 }
 
+float signedArea(const std::vector<glm::vec3>& _ring) {
+    if (_ring.empty()) {
+        return 0.f;
+    }
+    float area = 0.f;
+    const glm::vec3* prev = &_ring.back();
+    for (const auto& point : _ring) {
+        area += prev->x * point.y - point.x * prev->y;
+        prev = &point;
+    }
+    return 0.5f * area;
+}
+
 void wrapRad(double& _angle){
     if (_angle < -PI) _angle += PI*2.;
     if (_angle > PI) _angle -= PI*2.;
@@ -63,6 +63,11 @@
  */
 int signValue(float _n);
 
+/* Returns the signed area of the closed ring _ring in the xy plane, positive for counter-clockwise rings
+ * with y up; the ring may or may not repeat its first point at the end
+ */
+float signedArea(const std::vector<glm::vec3>& _ring);
+
 /* Returns an equivalent angle in radians between -PI and PI
  * Ex: wrapRad(3.24159265358979323846) == -0.1
  * Ex: wrapRad(6.28318530717958647693) == 0.0
@@ -0,0 +1,78 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const int Histogram::s_numBuckets;
+constexpr double Histogram::s_firstBucketLimit;
+
+void Histogram::add(double _ms) {
+
+    int bucket = 0;
+    while (bucket < s_numBuckets - 1 && _ms > getBucketLimit(bucket)) {
+        bucket++;
+    }
+    m_buckets[bucket]++;
+
+    m_min = m_count > 0 ? std::min(m_min, _ms) : _ms;
+    m_max = std::max(m_max, _ms);
+    m_sum += _ms;
+    m_count++;
+
+}
+
+void Histogram::merge(const Histogram& _other) {
+
+    if (_other.m_count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < s_numBuckets; i++) {
+        m_buckets[i] += _other.m_buckets[i];
+    }
+
+    m_min = m_count > 0 ? std::min(m_min, _other.m_min) : _other.m_min;
+    m_max = std::max(m_max, _other.m_max);
+    m_sum += _other.m_sum;
+    m_count += _other.m_count;
+
+}
+
+void Histogram::clear() {
+
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+
+}
+
+double Histogram::getPercentile(double _percentile) const {
+
+    if (m_count == 0) {
+        return 0;
+    }
+
+    size_t rank = (size_t)std::ceil(_percentile * m_count);
+    size_t seen = 0;
+
+    for (int i = 0; i < s_numBuckets; i++) {
+        seen += m_buckets[i];
+        if (seen >= rank && seen > 0) {
+            return std::min(getBucketLimit(i), m_max);
+        }
+    }
+
+    return m_max;
+}
+
+double Histogram::getBucketLimit(int _index) {
+
+    if (_index >= s_numBuckets - 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    return std::ldexp(s_firstBucketLimit, _index);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/* Distribution of durations in milliseconds
+ *
+ * Samples are counted in logarithmic buckets, each twice as wide as the previous one, starting at
+ * <s_firstBucketLimit>; percentiles are resolved to the upper limit of the bucket they fall in.
+ */
+class Histogram {
+
+public:
+
+    static const int s_numBuckets = 20;
+
+    // Upper limit of the first bucket, in milliseconds
+    static constexpr double s_firstBucketLimit = 0.125;
+
+    /* Adds a sample of @_ms milliseconds */
+    void add(double _ms);
+
+    /* Merges the samples of @_other into this histogram */
+    void merge(const Histogram& _other);
+
+    void clear();
+
+    size_t getCount() const { return m_count; }
+
+    double getMin() const { return m_count > 0 ? m_min : 0; }
+
+    double getMax() const { return m_max; }
+
+    double getMean() const { return m_count > 0 ? m_sum / m_count : 0; }
+
+    /* Returns an upper bound of the duration below which @_percentile (in [0, 1]) of the samples fall */
+    double getPercentile(double _percentile) const;
+
+    /* Returns the number of samples in the bucket at @_index */
+    size_t getBucketCount(int _index) const { return m_buckets[_index]; }
+
+    /* Returns the upper limit in milliseconds of the bucket at @_index; the last bucket is unbounded */
+    static double getBucketLimit(int _index);
+
+private:
+
+    std::array<size_t, s_numBuckets> m_buckets {};
+
+    size_t m_count = 0;
+    double m_sum = 0;
+    double m_min = 0;
+    double m_max = 0;
+
+};
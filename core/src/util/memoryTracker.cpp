@@ -0,0 +1,77 @@
+#include "memoryTracker.h"
+#include "platform.h"
+
+#include <algorithm>
+
+MemoryTracker::MemoryTracker() : m_budget(0) {
+
+    for (auto& usage : m_usage) {
+        usage = 0;
+    }
+
+}
+
+size_t MemoryTracker::getTotalUsage() const {
+
+    size_t total = 0;
+
+    for (const auto& usage : m_usage) {
+        total += usage;
+    }
+
+    return total;
+}
+
+int MemoryTracker::addEvictionHandler(EvictionStage _stage, EvictionHandler _handler) {
+
+    int id = m_nextHandlerId++;
+
+    // Keep handlers sorted by stage, in order of registration within a stage
+    auto it = std::upper_bound(m_handlers.begin(), m_handlers.end(), _stage,
+                               [](EvictionStage _s, const Handler& _h) { return _s < _h.stage; });
+    m_handlers.insert(it, { id, _stage, std::move(_handler) });
+
+    return id;
+}
+
+void MemoryTracker::removeEvictionHandler(int _id) {
+
+    m_handlers.erase(std::remove_if(m_handlers.begin(), m_handlers.end(),
+                                    [&](const Handler& _h) { return _h.id == _id; }),
+                     m_handlers.end());
+
+}
+
+void MemoryTracker::enforceBudget() {
+
+    size_t budget = m_budget;
+
+    if (budget == 0) {
+        return;
+    }
+
+    size_t usage = getTotalUsage();
+
+    if (usage <= budget) {
+        m_overBudget = false;
+        return;
+    }
+
+    for (auto& handler : m_handlers) {
+
+        if (usage <= budget) {
+            break;
+        }
+
+        handler.evict(usage - budget);
+        usage = getTotalUsage();
+    }
+
+    // Warn once each time the usage cannot be brought within the budget
+    bool overBudget = usage > budget;
+    if (overBudget && !m_overBudget) {
+        logMsg("WARNING: Memory usage of %zu bytes does not fit in the budget of %zu bytes\n", usage, budget);
+    }
+    m_overBudget = overBudget;
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/* Pools of memory reported to the <MemoryTracker> */
+enum class MemoryCategory {
+    tileData,       // Parsed <TileData>
+    meshData,       // CPU copies of compiled vertex and index data in <VboMesh>es
+    gpuBuffers,     // Vertex and index buffers uploaded to OpenGL
+    textures,       // OpenGL textures, including the transform textures of <TextBuffer>s
+    count
+};
+
+/* What an eviction handler releases, in the order in which handlers are run when over budget */
+enum class EvictionStage {
+    tileData,   // Parsed data that can be fetched or parsed again
+    meshData,   // CPU copies of meshes that are already uploaded
+    tiles,      // Whole tiles that are not visible
+    count
+};
+
+/* Memory accounting service
+ *
+ * Components report the bytes they hold in each <MemoryCategory>, either directly or through a
+ * <TrackedMemory> member. When a budget is set, <enforceBudget> runs the registered eviction
+ * handlers stage by stage until the total usage fits in the budget again. Reporting is thread
+ * safe; handlers are registered and run on the main thread.
+ */
+class MemoryTracker {
+
+public:
+
+    /* Releases up to the given number of bytes, returning the number of bytes released */
+    using EvictionHandler = std::function<size_t(size_t _bytes)>;
+
+    static MemoryTracker& GetInstance() {
+        static MemoryTracker instance;
+        return instance;
+    }
+
+    void add(MemoryCategory _category, size_t _bytes) { m_usage[(int)_category] += _bytes; }
+
+    void remove(MemoryCategory _category, size_t _bytes) { m_usage[(int)_category] -= _bytes; }
+
+    size_t getUsage(MemoryCategory _category) const { return m_usage[(int)_category]; }
+
+    size_t getTotalUsage() const;
+
+    /* Sets the number of bytes above which <enforceBudget> evicts data; 0 (the default) means no limit */
+    void setBudget(size_t _bytes) { m_budget = _bytes; }
+
+    size_t getBudget() const { return m_budget; }
+
+    /* Registers @_handler to run at @_stage when over budget; returns an id for <removeEvictionHandler> */
+    int addEvictionHandler(EvictionStage _stage, EvictionHandler _handler);
+
+    void removeEvictionHandler(int _id);
+
+    /* Runs eviction handlers, earliest stage first, until the total usage is within the budget */
+    void enforceBudget();
+
+private:
+
+    MemoryTracker();
+
+    struct Handler {
+        int id;
+        EvictionStage stage;
+        EvictionHandler evict;
+    };
+
+    std::atomic<size_t> m_usage[(int)MemoryCategory::count];
+
+    std::atomic<size_t> m_budget;
+
+    std::vector<Handler> m_handlers; // Sorted by stage
+    int m_nextHandlerId = 0;
+
+    bool m_overBudget = false;
+
+};
+
+/* Reports a number of bytes in a <MemoryCategory> for the lifetime of its owner */
+class TrackedMemory {
+
+public:
+
+    TrackedMemory(MemoryCategory _category) : m_category(_category) {}
+
+    ~TrackedMemory() { set(0); }
+
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    /* Replaces the reported number of bytes by @_bytes */
+    void set(size_t _bytes) {
+        auto& tracker = MemoryTracker::GetInstance();
+        tracker.remove(m_category, m_bytes);
+        tracker.add(m_category, _bytes);
+        m_bytes = _bytes;
+    }
+
+    size_t get() const { return m_bytes; }
+
+private:
+
+    MemoryCategory m_category;
+    size_t m_bytes = 0;
+
+};
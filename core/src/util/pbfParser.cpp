@@ -1,5 +1,6 @@
 #include "pbfParser.h"
 #include "platform.h"
+#include "util/clipping.h"
 
 #include <cmath>
 
@@ -158,7 +159,7 @@ void PbfParser::extractFeature(protobuf::message& _featureIn, Feature& _out, con
     
 }
 
-void PbfParser::extractLayer(protobuf::message& _layerIn, Layer& _out, const MapTile& _tile) {
+void PbfParser::extractLayer(protobuf::message& _layerIn, Layer& _out, const MapTile& _tile, const CancelToken& _cancel, float _clipBuffer) {
     
     std::vector<std::string> keys;
     std::vector<float> numericValues;
@@ -236,8 +237,18 @@ void PbfParser::extractLayer(protobuf::message& _layerIn, Layer& _out, const Map
         }
     }
     
+    glm::vec4 clipBounds = Clipping::getTileBounds(_clipBuffer);
+
+    size_t featureIndex = 0;
     for(auto& featureMsg : featureMsgs) {
+        if (_cancel.isCanceled(++featureIndex)) {
+            return;
+        }
         _out.features.emplace_back();
         extractFeature(featureMsg, _out.features.back(), _tile, keys, numericValues, stringValues, tileExtent);
+
+        if (_clipBuffer >= 0 && !Clipping::clipFeature(_out.features.back(), clipBounds)) {
+            _out.features.pop_back();
+        }
     }
 }
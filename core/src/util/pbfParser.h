@@ -8,6 +8,7 @@
 
 #include "mapTile.h"
 #include "tileData.h"
+#include "util/cancelToken.h"
 
 namespace PbfParser {
     
@@ -15,7 +16,12 @@ namespace PbfParser {
     
     void extractFeature(protobuf::message& _featureIn, Feature& _out, const MapTile& _tile, std::vector<std::string>& _keys, std::vector<float>& _numericValues, std::vector<std::string>& _stringValues, int _tileExtent);
     
-    void extractLayer(protobuf::message& _in, Layer& _out, const MapTile& _tile);
+    /* Extracts the features of @_in into @_out; stops early once @_cancel is canceled
+     *
+     * With a @_clipBuffer of zero or more, geometry is clipped to the tile extended by that fraction of its
+     * size, and features with no geometry left are dropped
+     */
+    void extractLayer(protobuf::message& _in, Layer& _out, const MapTile& _tile, const CancelToken& _cancel = CancelToken::none(), float _clipBuffer = -1.f);
     
     enum pbfGeomCmd {
         moveTo = 1,
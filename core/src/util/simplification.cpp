@@ -0,0 +1,145 @@
+#include "simplification.h"
+#include "geom.h"
+
+#include <utility>
+
+namespace Simplification {
+
+namespace {
+
+    /* Squared distance from @_p to the segment from @_a to @_b */
+    float sqSegmentDistance(const Point& _p, const Point& _a, const Point& _b) {
+
+        float x = _a.x, y = _a.y;
+        float dx = _b.x - x, dy = _b.y - y;
+
+        if (dx != 0.f || dy != 0.f) {
+            float t = ((_p.x - x) * dx + (_p.y - y) * dy) / (dx * dx + dy * dy);
+            if (t > 1.f) {
+                x = _b.x;
+                y = _b.y;
+            } else if (t > 0.f) {
+                x += dx * t;
+                y += dy * t;
+            }
+        }
+
+        dx = _p.x - x;
+        dy = _p.y - y;
+
+        return dx * dx + dy * dy;
+    }
+
+}
+
+void simplifyLine(const Line& _line, float _tolerance, Line& _out) {
+
+    size_t size = _line.size();
+
+    if (size <= 2 || _tolerance <= 0.f) {
+        _out.insert(_out.end(), _line.begin(), _line.end());
+        return;
+    }
+
+    float sqTolerance = _tolerance * _tolerance;
+
+    std::vector<bool> keep(size, false);
+    keep[0] = keep[size - 1] = true;
+
+    // Ranges still to be simplified; a stack rather than recursion, since lines can be very long
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.emplace_back(0, size - 1);
+
+    while (!ranges.empty()) {
+
+        size_t first = ranges.back().first;
+        size_t last = ranges.back().second;
+        ranges.pop_back();
+
+        float maxDistance = 0.f;
+        size_t index = 0;
+
+        for (size_t i = first + 1; i < last; i++) {
+            float distance = sqSegmentDistance(_line[i], _line[first], _line[last]);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                index = i;
+            }
+        }
+
+        if (maxDistance > sqTolerance) {
+            keep[index] = true;
+            ranges.emplace_back(first, index);
+            ranges.emplace_back(index, last);
+        }
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        if (keep[i]) {
+            _out.push_back(_line[i]);
+        }
+    }
+
+}
+
+bool simplifyFeature(Feature& _feature, float _tolerance) {
+
+    switch (_feature.geometryType) {
+        case GeometryType::POINTS:
+            return !_feature.points.empty();
+
+        case GeometryType::LINES: {
+            std::vector<Line> lines;
+            for (const auto& line : _feature.lines) {
+                Line simplified;
+                simplifyLine(line, _tolerance, simplified);
+                if (simplified.size() >= 2) {
+                    lines.push_back(std::move(simplified));
+                }
+            }
+            _feature.lines = std::move(lines);
+            return !_feature.lines.empty();
+        }
+
+        case GeometryType::POLYGONS: {
+            std::vector<Polygon> polygons;
+            for (const auto& polygon : _feature.polygons) {
+                if (polygon.empty()) {
+                    continue;
+                }
+                // Rings wound like the first one are outer rings, each followed by its holes, as in the
+                // multipolygons of vector tiles; a collapsed outer ring is dropped with its holes
+                int outerSign = signValue(signedArea(polygon.front()));
+                bool keepHoles = false;
+
+                Polygon simplified;
+                for (const auto& ring : polygon) {
+                    bool outer = signValue(signedArea(ring)) == outerSign;
+                    if (!outer && !keepHoles) {
+                        continue;
+                    }
+                    Line simplifiedRing;
+                    simplifyLine(ring, _tolerance, simplifiedRing);
+                    bool kept = simplifiedRing.size() >= 4;
+                    if (kept) {
+                        simplified.push_back(std::move(simplifiedRing));
+                    }
+                    if (outer) {
+                        keepHoles = kept;
+                    }
+                }
+                if (!simplified.empty()) {
+                    polygons.push_back(std::move(simplified));
+                }
+            }
+            _feature.polygons = std::move(polygons);
+            return !_feature.polygons.empty();
+        }
+
+        default:
+            return false;
+    }
+
+}
+
+}
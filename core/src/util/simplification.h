@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "data/tileData.h"
+
+/* Simplification of tile geometry with the Douglas-Peucker algorithm
+ *
+ * The tolerance is the largest distance, in the coordinates of the geometry, between a removed point and
+ * the simplified line. Lines that collapse to fewer than 2 points and rings that collapse to fewer than
+ * 4 points (including the closing point) are dropped; an outer ring of a polygon is dropped with its holes.
+ */
+namespace Simplification {
+
+    /* Appends the points of @_line kept with @_tolerance to @_out; the end points are always kept */
+    void simplifyLine(const Line& _line, float _tolerance, Line& _out);
+
+    /* Simplifies the lines and polygons of @_feature in place; returns false if no geometry is left */
+    bool simplifyFeature(Feature& _feature, float _tolerance);
+
+}
@@ -48,6 +48,8 @@ void Texture::destroy() {
         }
     }
     glDeleteTextures(1, &m_glHandle);
+
+    m_gpuMemory.set(0);
     
 }
 
@@ -137,6 +139,23 @@ void Texture::update(GLuint _textureUnit) {
     if (data || m_shouldResize) {
         glTexImage2D(m_target, 0, m_options.m_internalFormat, m_width, m_height, 0, m_options.m_format, GL_UNSIGNED_BYTE, data);
         m_shouldResize = false;
+
+        size_t bytesPerPixel;
+        switch (m_options.m_internalFormat) {
+            case GL_ALPHA:
+            case GL_LUMINANCE:
+                bytesPerPixel = 1;
+                break;
+            case GL_LUMINANCE_ALPHA:
+                bytesPerPixel = 2;
+                break;
+            case GL_RGB:
+                bytesPerPixel = 3;
+                break;
+            default:
+                bytesPerPixel = 4;
+        }
+        m_gpuMemory.set(m_width * m_height * bytesPerPixel);
     }
 
     // clear cpu data
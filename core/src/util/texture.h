@@ -3,6 +3,7 @@
 #include "gl.h"
 #include "platform.h"
 #include "geom.h"
+#include "util/memoryTracker.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -97,6 +98,8 @@ private:
     };
     
     bool m_autoDelete;
+
+    TrackedMemory m_gpuMemory { MemoryCategory::textures };
     
     // used to queue the subdata updates, each call of setSubData would be treated in the order that they arrived
     std::queue<std::unique_ptr<TextureSubData>> m_subData;
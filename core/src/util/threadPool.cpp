@@ -0,0 +1,128 @@
+#include "threadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t _numThreads) : m_pending(0), m_nextQueue(0) {
+
+    _numThreads = std::max<size_t>(_numThreads, 1);
+
+    for (size_t i = 0; i < _numThreads; i++) {
+        m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    for (size_t i = 0; i < _numThreads; i++) {
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+
+}
+
+size_t ThreadPool::defaultThreadCount() {
+
+    // hardware_concurrency() may return 0 when the value is not computable
+    size_t cores = std::thread::hardware_concurrency();
+
+    // Leave one core for the thread that renders the map
+    return cores > 1 ? cores - 1 : 1;
+
+}
+
+void ThreadPool::enqueue(Job _job) {
+
+    int index = workerIndex();
+
+    // Counted before the job can be taken, so that taking it never drops the count below zero
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_pending++;
+    }
+
+    if (index >= 0) {
+        // Sub-task of a running job: keep it local so that it is likely to run next on this thread
+        Queue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_front(std::move(_job));
+    } else {
+        Queue& queue = *m_queues[m_nextQueue++ % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(_job));
+    }
+
+    m_condition.notify_one();
+
+}
+
+bool ThreadPool::take(size_t _index, Job& _job) {
+
+    {
+        Queue& own = *m_queues[_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            _job = std::move(own.jobs.front());
+            own.jobs.pop_front();
+            m_pending--;
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < m_queues.size(); i++) {
+        Queue& victim = *m_queues[(_index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            _job = std::move(victim.jobs.back());
+            victim.jobs.pop_back();
+            m_pending--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run(size_t _index) {
+
+    Job job;
+
+    while (true) {
+
+        if (take(_index, job)) {
+            job();
+            job = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_condition.wait(lock, [&]{ return m_stop || m_pending > 0; });
+
+        if (m_stop && m_pending == 0) {
+            return;
+        }
+    }
+
+}
+
+int ThreadPool::workerIndex() const {
+
+    auto id = std::this_thread::get_id();
+
+    for (size_t i = 0; i < m_threads.size(); i++) {
+        if (m_threads[i].get_id() == id) {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Persistent pool of worker threads with work stealing
+ *
+ * Every worker thread owns a double-ended queue of jobs. Jobs enqueued from outside the pool are
+ * distributed round-robin to the back of these queues; jobs enqueued from a worker thread (e.g. sub-tasks
+ * of a running job) are pushed to the front of that worker's own queue. A worker takes jobs from the front
+ * of its own queue and, when that runs dry, steals from the back of the other workers' queues. Idle
+ * workers sleep until new jobs arrive.
+ */
+class ThreadPool {
+
+public:
+
+    using Job = std::function<void()>;
+
+    /* Starts a pool of _numThreads worker threads (at least one) */
+    ThreadPool(size_t _numThreads);
+
+    /* Runs all remaining jobs, then joins the worker threads */
+    ~ThreadPool();
+
+    /* Adds a job to be run on one of the worker threads */
+    void enqueue(Job _job);
+
+    /* Returns the number of worker threads in this pool */
+    size_t size() const { return m_threads.size(); }
+
+    /* Returns true if the calling thread is one of the worker threads of this pool */
+    bool isWorkerThread() const { return workerIndex() >= 0; }
+
+    /* Returns a thread count suited to the hardware: one less than the number of cores, but at least one */
+    static size_t defaultThreadCount();
+
+private:
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void run(size_t _index);
+
+    /* Takes a job from the front of queue @_index or, failing that, from the back of another queue */
+    bool take(size_t _index, Job& _job);
+
+    /* Returns the index of the calling worker thread, or -1 for threads outside the pool */
+    int workerIndex() const;
+
+    std::vector<std::thread> m_threads;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::atomic<size_t> m_pending; // Number of jobs enqueued but not yet taken by a worker
+    std::atomic<size_t> m_nextQueue; // Round-robin counter for jobs enqueued from outside the pool
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+
 /* An immutable identifier for a map tile 
  * 
  * Contains the x, y, and z indices of a tile in a quad tree; TileIDs are ordered by:
@@ -40,6 +43,15 @@ struct TileID {
         return TileID(x >> 1, y >> 1, z-1);
     }
 
+    /* Returns the tile at zoom @_zoom that contains this tile, or this tile if it is not deeper than @_zoom */
+    TileID getAncestor(int _zoom) const {
+        if (_zoom >= z) {
+            return *this;
+        }
+        int shift = z - _zoom;
+        return TileID(x >> shift, y >> shift, _zoom);
+    }
+
     TileID getChild(int _index) const {
         
         if (_index > 3 || _index < 0) {
@@ -55,7 +67,66 @@ struct TileID {
         
         return TileID((x<<1)+i, (y<<1)+j, z+1);
     }
+
+    /* Returns a 64-bit key unique to this tile, for valid tiles up to zoom 31
+     *
+     * The bits of x and y are interleaved (Morton order) below a leading 1 bit at position 2*z, so the
+     * key of an ancestor is found by shifting the key right by 2 bits per level and all descendants
+     * at a given depth fall into one contiguous range of keys. Invalid tiles return 0.
+     */
+    uint64_t getQuadKey() const {
+
+        if (z < 0 || z > 31 || x < 0 || y < 0) {
+            return 0;
+        }
+
+        return (uint64_t(1) << (2 * z)) | spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    /* Returns the tile for a key produced by <getQuadKey> */
+    static TileID fromQuadKey(uint64_t _key) {
+
+        int z = 0;
+        while (z < 31 && (_key >> (2 * (z + 1))) != 0) { z++; }
+
+        uint64_t morton = _key & ~(uint64_t(1) << (2 * z));
+
+        return TileID(compactBits(morton), compactBits(morton >> 1), z);
+    }
+
+private:
+
+    // Inserts a 0 bit above each of the lower 32 bits of _v
+    static uint64_t spreadBits(uint64_t _v) {
+        _v &= 0xffffffff;
+        _v = (_v | (_v << 16)) & 0x0000ffff0000ffff;
+        _v = (_v | (_v << 8))  & 0x00ff00ff00ff00ff;
+        _v = (_v | (_v << 4))  & 0x0f0f0f0f0f0f0f0f;
+        _v = (_v | (_v << 2))  & 0x3333333333333333;
+        _v = (_v | (_v << 1))  & 0x5555555555555555;
+        return _v;
+    }
+
+    // Inverse of spreadBits: gathers every other bit of _v, starting from the lowest
+    static int compactBits(uint64_t _v) {
+        _v &= 0x5555555555555555;
+        _v = (_v | (_v >> 1))  & 0x3333333333333333;
+        _v = (_v | (_v >> 2))  & 0x0f0f0f0f0f0f0f0f;
+        _v = (_v | (_v >> 4))  & 0x00ff00ff00ff00ff;
+        _v = (_v | (_v >> 8))  & 0x0000ffff0000ffff;
+        _v = (_v | (_v >> 16)) & 0x00000000ffffffff;
+        return int(_v);
+    }
     
 };
 
+namespace std {
+    template <>
+    struct hash<TileID> {
+        size_t operator()(const TileID& _tileID) const {
+            return std::hash<uint64_t>()(_tileID.getQuadKey());
+        }
+    };
+}
+
 static TileID NOT_A_TILE(-1, -1, -1);
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tileID.h"
+
+/* Associative container of values keyed by <TileID>, organized as a quadtree
+ *
+ * Entries are hashed on the quadkey of their TileID (see TileID::getQuadKey), for constant-time
+ * lookup, insertion and removal. Parents are found by shifting quadkeys, so ancestor queries cost
+ * one lookup per level. Iteration follows the ordering of TileIDs; the ordered view, along with a
+ * list of quadkeys sorted for descendant range queries, is rebuilt lazily after modifications.
+ *
+ * Pointers and references to values remain valid until their entry is erased; iterators are
+ * invalidated by any insertion or removal.
+ */
+template <typename T>
+class TileIndex {
+
+public:
+
+    using value_type = std::pair<const TileID, T>;
+
+    class const_iterator : public std::iterator<std::forward_iterator_tag, value_type> {
+    public:
+        const_iterator(typename std::vector<value_type*>::const_iterator _it) : m_it(_it) {}
+        value_type& operator*() const { return **m_it; }
+        value_type* operator->() const { return *m_it; }
+        const_iterator& operator++() { ++m_it; return *this; }
+        const_iterator operator++(int) { const_iterator tmp(*this); ++m_it; return tmp; }
+        bool operator==(const const_iterator& _rhs) const { return m_it == _rhs.m_it; }
+        bool operator!=(const const_iterator& _rhs) const { return m_it != _rhs.m_it; }
+    private:
+        typename std::vector<value_type*>::const_iterator m_it;
+    };
+
+    /* Returns a pointer to the value for @_tileID, or nullptr if there is none */
+    T* find(const TileID& _tileID) {
+        auto it = m_entries.find(_tileID.getQuadKey());
+        return it != m_entries.end() ? &it->second.second : nullptr;
+    }
+
+    const T* find(const TileID& _tileID) const {
+        auto it = m_entries.find(_tileID.getQuadKey());
+        return it != m_entries.end() ? &it->second.second : nullptr;
+    }
+
+    bool contains(const TileID& _tileID) const {
+        return m_entries.find(_tileID.getQuadKey()) != m_entries.end();
+    }
+
+    size_t count(const TileID& _tileID) const { return contains(_tileID) ? 1 : 0; }
+
+    /* Returns the value for @_tileID, inserting a default-constructed value if there is none */
+    T& operator[](const TileID& _tileID) {
+        auto it = m_entries.find(_tileID.getQuadKey());
+        if (it == m_entries.end()) {
+            it = m_entries.emplace(std::piecewise_construct,
+                                   std::forward_as_tuple(_tileID.getQuadKey()),
+                                   std::forward_as_tuple(std::piecewise_construct,
+                                                         std::forward_as_tuple(_tileID),
+                                                         std::forward_as_tuple())).first;
+            m_sorted = false;
+        }
+        return it->second.second;
+    }
+
+    /* Removes the entry for @_tileID; returns false if there was none */
+    bool erase(const TileID& _tileID) {
+        if (m_entries.erase(_tileID.getQuadKey()) == 0) {
+            return false;
+        }
+        m_sorted = false;
+        return true;
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_sorted = false;
+    }
+
+    size_t size() const { return m_entries.size(); }
+
+    bool empty() const { return m_entries.empty(); }
+
+    /* Returns the entry of the nearest ancestor of @_tileID that is in the index, looking at most
+     * @_maxDepth levels up, or nullptr if there is none */
+    value_type* findAncestor(const TileID& _tileID, int _maxDepth = 32) {
+        uint64_t key = _tileID.getQuadKey();
+        for (int depth = 1; depth <= _maxDepth && depth <= _tileID.z; depth++) {
+            auto it = m_entries.find(key >> (2 * depth));
+            if (it != m_entries.end()) {
+                return &it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /* Appends the entries of all descendants of @_tileID that are in the index, at most @_maxDepth
+     * levels down, to @_out; entries are added level by level, in ascending quadkey order */
+    void findDescendants(const TileID& _tileID, int _maxDepth, std::vector<value_type*>& _out) const {
+        sort();
+        uint64_t key = _tileID.getQuadKey();
+        for (int depth = 1; depth <= _maxDepth && _tileID.z + depth <= 31; depth++) {
+            // Keys of descendants at this depth form the range [key << 2d, (key + 1) << 2d)
+            uint64_t first = key << (2 * depth);
+            uint64_t last = (key + 1) << (2 * depth);
+            auto it = std::lower_bound(m_keys.begin(), m_keys.end(), first,
+                                       [](const std::pair<uint64_t, value_type*>& _entry, uint64_t _key) { return _entry.first < _key; });
+            for (; it != m_keys.end() && it->first < last; ++it) {
+                _out.push_back(it->second);
+            }
+        }
+    }
+
+    /* Returns true if any descendant of @_tileID, at most @_maxDepth levels down, is in the index */
+    bool hasDescendants(const TileID& _tileID, int _maxDepth = 32) const {
+        std::vector<value_type*> descendants;
+        findDescendants(_tileID, _maxDepth, descendants);
+        return !descendants.empty();
+    }
+
+    /* Iteration in <TileID> order */
+    const_iterator begin() const { sort(); return const_iterator(m_ordered.begin()); }
+    const_iterator end() const { sort(); return const_iterator(m_ordered.end()); }
+
+private:
+
+    void sort() const {
+        if (m_sorted) {
+            return;
+        }
+
+        m_ordered.clear();
+        m_keys.clear();
+        m_ordered.reserve(m_entries.size());
+        m_keys.reserve(m_entries.size());
+
+        for (auto& entry : m_entries) {
+            value_type* value = const_cast<value_type*>(&entry.second);
+            m_ordered.push_back(value);
+            m_keys.emplace_back(entry.first, value);
+        }
+
+        std::sort(m_ordered.begin(), m_ordered.end(), [](const value_type* _a, const value_type* _b) { return _a->first < _b->first; });
+        std::sort(m_keys.begin(), m_keys.end(), [](const std::pair<uint64_t, value_type*>& _a, const std::pair<uint64_t, value_type*>& _b) { return _a.first < _b.first; });
+
+        m_sorted = true;
+    }
+
+    std::unordered_map<uint64_t, value_type> m_entries; // Entries by quadkey
+
+    mutable std::vector<value_type*> m_ordered; // Entries in TileID order
+    mutable std::vector<std::pair<uint64_t, value_type*>> m_keys; // Entries in quadkey order
+    mutable bool m_sorted = true;
+
+};
@@ -0,0 +1,265 @@
+#include "topoJson.h"
+#include "geoJson.h"
+#include "platform.h"
+#include "util/clipping.h"
+#include "util/mapProjection.h"
+
+#include <cstring>
+
+namespace {
+
+    Point projectPoint(const glm::dvec2& _lonLat, const MapTile& _tile) {
+
+        glm::dvec2 meters = _tile.getProjection()->LonLatToMeters(_lonLat);
+
+        return Point((meters.x - _tile.getOrigin().x) * _tile.getInverseScale(),
+                     (meters.y - _tile.getOrigin().y) * _tile.getInverseScale(), 0.f);
+    }
+
+    glm::dvec2 readPosition(const rapidjson::Value& _in) {
+
+        if (!_in.IsArray() || _in.Size() < 2 || !_in[0].IsNumber() || !_in[1].IsNumber()) {
+            return glm::dvec2(0.0);
+        }
+
+        return glm::dvec2(_in[0].GetDouble(), _in[1].GetDouble());
+    }
+
+    /* Appends arc @_index of @_topology to @_out, skipping the point it shares with the previous arc */
+    void appendArc(int _index, Line& _out, const TopoJson::Topology& _topology) {
+
+        bool reversed = _index < 0;
+        size_t arcIndex = reversed ? ~_index : _index;
+
+        if (arcIndex >= _topology.arcs.size()) {
+            logMsg("ERROR: TopoJSON arc index %d is out of range\n", _index);
+            return;
+        }
+
+        const Line& arc = _topology.arcs[arcIndex];
+        size_t skip = _out.empty() ? 0 : 1;
+
+        if (arc.size() <= skip) {
+            return;
+        }
+
+        if (reversed) {
+            _out.insert(_out.end(), arc.rbegin() + skip, arc.rend());
+        } else {
+            _out.insert(_out.end(), arc.begin() + skip, arc.end());
+        }
+    }
+
+}
+
+void TopoJson::extractTopology(const rapidjson::Value& _in, Topology& _out, const MapTile& _tile) {
+
+    auto transformIter = _in.FindMember("transform");
+
+    if (transformIter != _in.MemberEnd() && transformIter->value.IsObject()) {
+        const rapidjson::Value& transform = transformIter->value;
+        auto scale = transform.FindMember("scale");
+        auto translate = transform.FindMember("translate");
+        if (scale != transform.MemberEnd() && translate != transform.MemberEnd()) {
+            _out.transform.scale = readPosition(scale->value);
+            _out.transform.translate = readPosition(translate->value);
+            _out.quantized = true;
+        }
+    }
+
+    auto arcsIter = _in.FindMember("arcs");
+
+    if (arcsIter == _in.MemberEnd() || !arcsIter->value.IsArray()) {
+        return;
+    }
+
+    const rapidjson::Value& arcs = arcsIter->value;
+    _out.arcs.reserve(arcs.Size());
+
+    // Each arc is projected once, however many geometries share it
+    for (auto arcJson = arcs.Begin(); arcJson != arcs.End(); ++arcJson) {
+
+        _out.arcs.emplace_back();
+        Line& arc = _out.arcs.back();
+
+        if (!arcJson->IsArray()) {
+            continue;
+        }
+
+        arc.reserve(arcJson->Size());
+
+        // Quantized arcs store the first position and then the difference to the previous position
+        glm::dvec2 position(0.0);
+
+        for (auto pointJson = arcJson->Begin(); pointJson != arcJson->End(); ++pointJson) {
+            glm::dvec2 lonLat;
+            if (_out.quantized) {
+                position += readPosition(*pointJson);
+                lonLat = position * _out.transform.scale + _out.transform.translate;
+            } else {
+                lonLat = readPosition(*pointJson);
+            }
+            arc.push_back(projectPoint(lonLat, _tile));
+        }
+    }
+
+}
+
+void TopoJson::extractPoint(const rapidjson::Value& _in, Point& _out, const Topology& _topology, const MapTile& _tile) {
+
+    // Positions of points are quantized, but not delta-encoded
+    glm::dvec2 lonLat = readPosition(_in);
+
+    if (_topology.quantized) {
+        lonLat = lonLat * _topology.transform.scale + _topology.transform.translate;
+    }
+
+    _out = projectPoint(lonLat, _tile);
+
+}
+
+void TopoJson::extractLine(const rapidjson::Value& _in, Line& _out, const Topology& _topology) {
+
+    if (!_in.IsArray()) {
+        return;
+    }
+
+    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
+        if (itr->IsInt()) {
+            appendArc(itr->GetInt(), _out, _topology);
+        }
+    }
+
+}
+
+void TopoJson::extractPoly(const rapidjson::Value& _in, Polygon& _out, const Topology& _topology) {
+
+    if (!_in.IsArray()) {
+        return;
+    }
+
+    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
+        _out.emplace_back();
+        extractLine(*itr, _out.back(), _topology);
+    }
+
+}
+
+bool TopoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const Topology& _topology, const MapTile& _tile) {
+
+    auto typeIter = _in.FindMember("type");
+    if (typeIter == _in.MemberEnd() || !typeIter->value.IsString()) {
+        return false;
+    }
+
+    const std::string& geometryType = typeIter->value.GetString();
+
+    auto propertiesIter = _in.FindMember("properties");
+    if (propertiesIter != _in.MemberEnd() && propertiesIter->value.IsObject()) {
+        GeoJson::extractProperties(propertiesIter->value, _out.props, _tile);
+    }
+
+    if (geometryType.compare("Point") == 0 || geometryType.compare("MultiPoint") == 0) {
+
+        auto coordsIter = _in.FindMember("coordinates");
+        if (coordsIter == _in.MemberEnd() || !coordsIter->value.IsArray()) {
+            return false;
+        }
+        const rapidjson::Value& coords = coordsIter->value;
+
+        _out.geometryType = GeometryType::POINTS;
+
+        if (geometryType.compare("Point") == 0) {
+            _out.points.emplace_back();
+            extractPoint(coords, _out.points.back(), _topology, _tile);
+        } else {
+            for (auto pointCoords = coords.Begin(); pointCoords != coords.End(); ++pointCoords) {
+                _out.points.emplace_back();
+                extractPoint(*pointCoords, _out.points.back(), _topology, _tile);
+            }
+        }
+
+        return true;
+    }
+
+    auto arcsIter = _in.FindMember("arcs");
+    if (arcsIter == _in.MemberEnd() || !arcsIter->value.IsArray()) {
+        return false;
+    }
+    const rapidjson::Value& arcs = arcsIter->value;
+
+    if (geometryType.compare("LineString") == 0) {
+
+        _out.geometryType = GeometryType::LINES;
+        _out.lines.emplace_back();
+        extractLine(arcs, _out.lines.back(), _topology);
+
+    } else if (geometryType.compare("MultiLineString") == 0) {
+
+        _out.geometryType = GeometryType::LINES;
+        for (auto lineArcs = arcs.Begin(); lineArcs != arcs.End(); ++lineArcs) {
+            _out.lines.emplace_back();
+            extractLine(*lineArcs, _out.lines.back(), _topology);
+        }
+
+    } else if (geometryType.compare("Polygon") == 0) {
+
+        _out.geometryType = GeometryType::POLYGONS;
+        _out.polygons.emplace_back();
+        extractPoly(arcs, _out.polygons.back(), _topology);
+
+    } else if (geometryType.compare("MultiPolygon") == 0) {
+
+        _out.geometryType = GeometryType::POLYGONS;
+        for (auto polyArcs = arcs.Begin(); polyArcs != arcs.End(); ++polyArcs) {
+            _out.polygons.emplace_back();
+            extractPoly(*polyArcs, _out.polygons.back(), _topology);
+        }
+
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void TopoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const Topology& _topology, const MapTile& _tile, const CancelToken& _cancel, float _clipBuffer) {
+
+    if (!_in.IsObject()) {
+        return;
+    }
+
+    auto typeIter = _in.FindMember("type");
+    bool isCollection = typeIter != _in.MemberEnd() && typeIter->value.IsString() &&
+                        std::strcmp(typeIter->value.GetString(), "GeometryCollection") == 0;
+
+    if (!isCollection) {
+        _out.features.emplace_back();
+        if (!extractFeature(_in, _out.features.back(), _topology, _tile)) {
+            _out.features.pop_back();
+        } else if (_clipBuffer >= 0) {
+            if (!Clipping::clipFeature(_out.features.back(), Clipping::getTileBounds(_clipBuffer))) {
+                _out.features.pop_back();
+            }
+        }
+        return;
+    }
+
+    auto geometriesIter = _in.FindMember("geometries");
+
+    if (geometriesIter == _in.MemberEnd() || !geometriesIter->value.IsArray()) {
+        logMsg("ERROR: TopoJSON GeometryCollection missing 'geometries' member\n");
+        return;
+    }
+
+    const auto& geometries = geometriesIter->value;
+    size_t featureIndex = 0;
+    for (auto geometry = geometries.Begin(); geometry != geometries.End(); ++geometry) {
+        if (_cancel.isCanceled(++featureIndex)) {
+            return;
+        }
+        // Nested collections are flattened into the layer
+        extractLayer(*geometry, _out, _topology, _tile, _cancel, _clipBuffer);
+    }
+
+}
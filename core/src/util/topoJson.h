@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "rapidjson/document.h"
+
+#include "mapTile.h"
+#include "tileData.h"
+#include "util/cancelToken.h"
+
+/* Functions for reading TopoJSON (https://github.com/mbostock/topojson-specification) into <TileData>
+ *
+ * A topology stores each line shared between geometries, e.g. a border between two polygons, only once
+ * as an 'arc'; geometries list the arcs they are made of. Arcs are decoded once per topology with
+ * <extractTopology> and then stitched into the lines and polygon rings of each geometry.
+ */
+namespace TopoJson {
+
+    /* Transform from quantized positions to longitude and latitude */
+    struct Transform {
+        glm::dvec2 scale = { 1.0, 1.0 };
+        glm::dvec2 translate = { 0.0, 0.0 };
+    };
+
+    /* Arcs of a topology in tile coordinates */
+    struct Topology {
+        Transform transform;
+        bool quantized = false;
+        std::vector<Line> arcs;
+    };
+
+    /* Reads the transform of the topology @_in and decodes its delta-encoded arcs into @_out */
+    void extractTopology(const rapidjson::Value& _in, Topology& _out, const MapTile& _tile);
+
+    void extractPoint(const rapidjson::Value& _in, Point& _out, const Topology& _topology, const MapTile& _tile);
+
+    /* Joins the arcs listed in @_in into a line; negative indices ~i refer to arc i in reverse */
+    void extractLine(const rapidjson::Value& _in, Line& _out, const Topology& _topology);
+
+    void extractPoly(const rapidjson::Value& _in, Polygon& _out, const Topology& _topology);
+
+    /* Extracts the geometry object @_in into @_out; returns false if its type is not supported */
+    bool extractFeature(const rapidjson::Value& _in, Feature& _out, const Topology& _topology, const MapTile& _tile);
+
+    /* Extracts the features of the object @_in, a geometry collection or a single geometry, into @_out;
+     * stops early once @_cancel is canceled. With a @_clipBuffer of zero or more, geometry is clipped to
+     * the tile extended by that fraction of its size */
+    void extractLayer(const rapidjson::Value& _in, Layer& _out, const Topology& _topology, const MapTile& _tile,
+                      const CancelToken& _cancel = CancelToken::none(), float _clipBuffer = -1.f);
+
+}
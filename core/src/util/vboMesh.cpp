@@ -4,6 +4,7 @@
 #define MAX_INDEX_VALUE 65535 // Maximum value of GLushort
 
 int VboMesh::s_validGeneration = 0;
+bool VboMesh::s_releasedData = false;
 
 VboMesh::VboMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode)
     : m_vertexLayout(_vertexLayout) {
@@ -59,6 +60,42 @@ void VboMesh::setDrawMode(GLenum _drawMode) {
     }
 }
 
+size_t VboMesh::bufferSize() const {
+
+    size_t vertexBytes = m_vertexLayout ? m_nVertices * m_vertexLayout->getStride() : 0;
+
+    return vertexBytes + m_nIndices * sizeof(GLushort);
+
+}
+
+size_t VboMesh::getMemoryUsage() const {
+
+    // Buffers not yet uploaded are counted as GPU memory they will use
+    size_t gpuBytes = m_isCompiled ? bufferSize() : 0;
+
+    return gpuBytes + m_cpuMemory.get();
+
+}
+
+size_t VboMesh::releaseCpuData() {
+
+    if (!m_isUploaded || !m_glVertexData) {
+        return 0;
+    }
+
+    delete[] m_glVertexData;
+    delete[] m_glIndexData;
+    m_glVertexData = nullptr;
+    m_glIndexData = nullptr;
+
+    size_t bytes = m_cpuMemory.get();
+    m_cpuMemory.set(0);
+
+    s_releasedData = true;
+
+    return bytes;
+}
+
 void VboMesh::upload() {
     // Generate vertex buffer, if needed
     if (m_glVertexBuffer == 0) {
@@ -83,13 +120,11 @@ void VboMesh::upload() {
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, GL_STATIC_DRAW);
     }
 
-    // m_glVertexData.resize(0);
-    // m_glIndexData.resize(0);
+    // We retain copies of the vertex and index data in CPU memory to allow VBOs to easily rebuild
+    // themselves after GL context loss, unless the memory budget requires them to be released with
+    // releaseCpuData(); tiles are then rebuilt from their data sources instead.
 
-    // TODO: For now, we retain copies of the vertex and index data in CPU memory to allow VBOs
-    // to easily rebuild themselves after GL context loss. For optimizing memory usage (and for
-    // other reasons) we'll want to change this in the future. This probably means going back to
-    // data sources and styles to rebuild the vertex data.
+    m_gpuMemory.set(bufferSize());
     
     m_generation = s_validGeneration;
 
@@ -150,6 +185,12 @@ void VboMesh::checkValidity() {
         m_isUploaded = false;
         m_glVertexBuffer = 0;
         m_glIndexBuffer = 0;
+        m_gpuMemory.set(0);
+
+        if (!m_glVertexData) {
+            // Data was released after upload, nothing left to draw
+            m_isCompiled = false;
+        }
         
         m_generation = s_validGeneration;
     }
@@ -5,6 +5,7 @@
 
 #include "gl.h"
 #include "vertexLayout.h"
+#include "util/memoryTracker.h"
 #include <cstring>
 
 #define MAX_INDEX_VALUE 65535
@@ -47,8 +48,25 @@ public:
         return m_nIndices;
     }
 
+    /* Returns the size in bytes of the compiled vertex and index data of this mesh */
+    size_t bufferSize() const;
+
+    /* Returns the memory held by this mesh: its GPU buffers plus the CPU copy of its data, if kept */
+    size_t getMemoryUsage() const;
+
+    /*
+     * Frees the CPU copy of the compiled data once it is uploaded, returning the number of bytes freed;
+     * the mesh can then no longer be drawn after a GL context loss, see <hasReleasedData>
+     */
+    size_t releaseCpuData();
+
     virtual void compileVertexBuffer() = 0;
 
+    bool isCompiled() const { return m_isCompiled; }
+
+    /* Returns true if the geometry was uploaded; after a GL context loss this is only updated by the next draw */
+    bool isUploaded() const { return m_isUploaded; }
+
     /*
      * Copies all added vertices and indices into OpenGL buffer objects; After geometry is uploaded,
      * no more vertices or indices can be added
@@ -67,8 +85,13 @@ public:
     
     static void invalidateAllVBOs();
 
+    /* Returns true if any mesh released its CPU data, so that tiles must be rebuilt after a GL context loss */
+    static bool hasReleasedData() { return s_releasedData; }
+
 protected:
 
+    static bool s_releasedData;
+
     static int s_validGeneration; // Incremented when the GL context is invalidated
     int m_generation; // Generation in which this mesh's GL handles were created
 
@@ -92,6 +115,9 @@ protected:
 
     bool m_isUploaded;
     bool m_isCompiled;
+
+    TrackedMemory m_cpuMemory { MemoryCategory::meshData };
+    TrackedMemory m_gpuMemory { MemoryCategory::gpuBuffers };
     
     void checkValidity();
 
@@ -146,6 +172,8 @@ protected:
 
         m_vertexOffsets.emplace_back(indexOffset, vertexOffset);
 
+        m_cpuMemory.set(bufferSize());
+
         m_isCompiled = true;
     }
 };
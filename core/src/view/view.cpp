@@ -10,6 +10,7 @@
 #include "glm/gtx/rotate_vector.hpp"
 
 constexpr float View::s_maxZoom; // Create a stack reference to the static member variable
+constexpr float View::s_velocitySmoothing;
 
 double invLodFunc(double d) {
     return exp2(d) - 1.0;
@@ -22,6 +23,9 @@ View::View(int _width, int _height, ProjectionType _projType) {
     setZoom(m_initZoom); // Arbitrary zoom for testing
 
     setPosition(0.0, 0.0);
+
+    m_lastPos = glm::dvec2(m_pos.x, m_pos.y);
+    m_lastZoom = m_zoom;
     
     m_changed = false;
     m_dirty = true;
@@ -128,25 +132,38 @@ void View::orbit(float _x, float _y, float _radians) {
     
 }
 
-void View::update() {
+void View::update(float _dt) {
     
-    if (!m_dirty) {
+    bool freezeTiles = Tangram::getDebugFlag(Tangram::DebugFlags::FREEZE_TILES);
+
+    if (m_dirty) {
+
+        updateMatrices();
+
+        if (!freezeTiles) {
+
+            updateTiles();
+
+        }
+
+        m_changed = true;
+
+        m_dirty = false;
+
+    } else {
+
         m_changed = false;
-        return;
+
     }
-    
-    updateMatrices();
-    
-    if (!Tangram::getDebugFlag(Tangram::DebugFlags::FREEZE_TILES)) {
-        
-        updateTiles();
-        
+
+    updateVelocity(_dt);
+
+    if (!freezeTiles) {
+
+        updatePrefetchTiles();
+
     }
     
-    m_changed = true;
-    
-    m_dirty = false;
-    
 }
 
 glm::dmat2 View::getBoundsRect() const {
@@ -313,8 +330,71 @@ static void scanTriangle(glm::dvec2& _a, glm::dvec2& _b, glm::dvec2& _c, int _mi
 }
 
 void View::updateTiles() {
-    
+
     m_visibleTiles.clear();
+
+    rasterizeTiles(glm::dvec2(m_pos.x, m_pos.y), m_zoom, m_visibleTiles);
+
+}
+
+void View::updateVelocity(float _dt) {
+
+    if (_dt <= 0.f) {
+        return;
+    }
+
+    glm::dvec2 displacement = glm::dvec2(m_pos.x, m_pos.y) - m_lastPos;
+    float zoomChange = m_zoom - m_lastZoom;
+
+    m_lastPos = glm::dvec2(m_pos.x, m_pos.y);
+    m_lastZoom = m_zoom;
+
+    // A jump of more than a few screens is a call to setPosition, not a motion to extrapolate
+    if (glm::length(displacement) > 4.0 * std::max(m_width, m_height)) {
+        m_velocity = glm::dvec2(0.0);
+        m_zoomVelocity = 0.f;
+        return;
+    }
+
+    // Smooth the velocity over a few frames, since frame intervals are not regular
+    m_velocity += (displacement / (double)_dt - m_velocity) * (double)s_velocitySmoothing;
+    m_zoomVelocity += (zoomChange / _dt - m_zoomVelocity) * s_velocitySmoothing;
+
+}
+
+void View::updatePrefetchTiles() {
+
+    std::set<TileID> prefetchTiles;
+
+    if (m_prefetchTime > 0.f) {
+
+        glm::dvec2 position(m_pos.x, m_pos.y);
+        glm::dvec2 predictedPosition = position + m_velocity * (double)m_prefetchTime;
+        float predictedZoom = glm::clamp(m_zoom + m_zoomVelocity * m_prefetchTime, 0.0f, s_maxZoom);
+
+        // Skip predictions that are within a fraction of a tile of the current view
+        double worldTileSize = 2 * MapProjection::HALF_CIRCUMFERENCE * pow(2, -m_zoom);
+        bool moving = glm::length(predictedPosition - position) > 0.25 * worldTileSize;
+        bool zooming = int(predictedZoom) != int(m_zoom);
+
+        if (moving || zooming) {
+            rasterizeTiles(predictedPosition, predictedZoom, prefetchTiles);
+
+            for (const auto& id : m_visibleTiles) {
+                prefetchTiles.erase(id);
+            }
+        }
+    }
+
+    m_prefetchChanged = prefetchTiles != m_prefetchTiles;
+
+    if (m_prefetchChanged) {
+        m_prefetchTiles.swap(prefetchTiles);
+    }
+
+}
+
+void View::rasterizeTiles(const glm::dvec2& _position, float _zoom, std::set<TileID>& _tiles) const {
     
     // Bounds of view trapezoid in world space (i.e. view frustum projected onto z = 0 plane)
     glm::vec2 viewBL = { 0.f,       m_vpHeight }; // bottom left
@@ -331,26 +411,31 @@ void View::updateTiles() {
     if (t0 < .0f && t1 < 0.f && t2 < 0.f && t3 < 0.f) {
         return;
     }
+
+    // The trapezoid is computed for the current zoom; scale it to the area seen at @_zoom
+    double scale = exp2(m_zoom - _zoom);
+    double width = m_width * scale;
+    double height = m_height * scale;
     
     // Transformation from world space to tile space
     double hc = MapProjection::HALF_CIRCUMFERENCE;
-    double invTileSize = double(1 << int(m_zoom)) / (hc * 2);
+    double invTileSize = double(1 << int(_zoom)) / (hc * 2);
     glm::dvec2 tileSpaceOrigin(-hc, hc);
     glm::dvec2 tileSpaceAxes(invTileSize, -invTileSize);
     
     // Bounds of view trapezoid in tile space
-    glm::dvec2 a = (glm::dvec2(viewBL.x + m_pos.x, viewBL.y + m_pos.y) - tileSpaceOrigin) * tileSpaceAxes;
-    glm::dvec2 b = (glm::dvec2(viewBR.x + m_pos.x, viewBR.y + m_pos.y) - tileSpaceOrigin) * tileSpaceAxes;
-    glm::dvec2 c = (glm::dvec2(viewTR.x + m_pos.x, viewTR.y + m_pos.y) - tileSpaceOrigin) * tileSpaceAxes;
-    glm::dvec2 d = (glm::dvec2(viewTL.x + m_pos.x, viewTL.y + m_pos.y) - tileSpaceOrigin) * tileSpaceAxes;
+    glm::dvec2 a = (glm::dvec2(viewBL) * scale + _position - tileSpaceOrigin) * tileSpaceAxes;
+    glm::dvec2 b = (glm::dvec2(viewBR) * scale + _position - tileSpaceOrigin) * tileSpaceAxes;
+    glm::dvec2 c = (glm::dvec2(viewTR) * scale + _position - tileSpaceOrigin) * tileSpaceAxes;
+    glm::dvec2 d = (glm::dvec2(viewTL) * scale + _position - tileSpaceOrigin) * tileSpaceAxes;
 
     // Location of the view center in tile space
-    glm::dvec2 e = (glm::dvec2(m_pos.x, m_pos.y) - tileSpaceOrigin) * tileSpaceAxes;
+    glm::dvec2 e = (_position - tileSpaceOrigin) * tileSpaceAxes;
     
     // Determine zoom reduction for tiles far from the center of view
-    double tilesAtFullZoom = std::max(m_width, m_height) * invTileSize * 0.5;
-    double viewCenterX = (m_pos.x + hc) * invTileSize;
-    double viewCenterY = (m_pos.y - hc) * -invTileSize;
+    double tilesAtFullZoom = std::max(width, height) * invTileSize * 0.5;
+    double viewCenterX = (_position.x + hc) * invTileSize;
+    double viewCenterY = (_position.y - hc) * -invTileSize;
     
     int x_l_pos[MAX_LOD] = { 0 };
     int x_l_neg[MAX_LOD] = { 0 };
@@ -373,18 +458,18 @@ void View::updateTiles() {
         while (lod < MAX_LOD && y >= y_l_pos[lod]) { lod++; }
         while (lod < MAX_LOD && y <  y_l_neg[lod]) { lod++; }
         
-        int z = int(m_zoom);
+        int z = int(_zoom);
         
         x >>= lod;
         y >>= lod;
         z = glm::clamp((z-lod), 0, (int)s_maxZoom);
         
-        m_visibleTiles.emplace(x, y, z);
+        _tiles.emplace(x, y, z);
         
     };
     
     // Rasterize view trapezoid into tiles
-    int maxTileIndex = 1 << int(m_zoom);
+    int maxTileIndex = 1 << int(_zoom);
     scanTriangle(a, b, c, 0, maxTileIndex, s);
     scanTriangle(c, d, a, 0, maxTileIndex, s);
 
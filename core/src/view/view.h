@@ -4,6 +4,7 @@
 #include <set>
 #include <memory>
 
+#include "glm/vec2.hpp"
 #include "glm/mat4x4.hpp"
 #include "glm/vec4.hpp"
 #include "glm/vec3.hpp"
@@ -41,6 +42,9 @@ public:
      */
     void setPixelScale(float _pixelsPerPoint);
 
+    /* Gets the size of a tile on screen in pixels, at the zoom of the tile */
+    float getPixelsPerTile() const { return m_pixelsPerTile * m_pixelScale; }
+
     /* Sets the size of the viewable area in pixels */
     void setSize(int _width, int _height);
     
@@ -81,8 +85,11 @@ public:
     /* Get the current pitch angle in radians */
     float getPitch() const { return m_pitch; }
     
-    /* Updates the view and projection matrices if properties have changed */
-    void update();
+    /* Updates the view and projection matrices if properties have changed
+     *
+     * @_dt is the time in seconds since the last update, used to estimate the motion of the view
+     */
+    void update(float _dt = 0.f);
     
     /* Gets the position of the view in projection units (z is the effective 'height' determined from zoom) */
     const glm::dvec3& getPosition() const { return m_pos; }
@@ -120,17 +127,44 @@ public:
     /* Returns true if the view properties have changed since the last call to update() */
     bool changedOnLastUpdate() const { return m_changed; }
 
+    /* Sets how far ahead, in seconds, the motion of the view is extrapolated to find tiles to prefetch; 0 disables prefetching */
+    void setPrefetchTime(float _seconds) { m_prefetchTime = _seconds; }
+
+    float getPrefetchTime() const { return m_prefetchTime; }
+
+    /* Returns the set of tiles expected to become visible if the view keeps its current motion; does not
+     * contain any of the visible tiles */
+    const std::set<TileID>& getPrefetchTiles() const { return m_prefetchTiles; }
+
+    /* Returns true if the set of prefetch tiles changed on the last call to update() */
+    bool prefetchChangedOnLastUpdate() const { return m_prefetchChanged; }
+
+    /* Gets the estimated velocity of the view position in projection units per second */
+    const glm::dvec2& getVelocity() const { return m_velocity; }
+
+    /* Gets the estimated rate of change of the zoom level per second */
+    float getZoomVelocity() const { return m_zoomVelocity; }
+
     virtual ~View() {}
     
     constexpr static float s_maxZoom = 18.0;
 
+    // Weight of the newest sample in the running estimate of the view velocity
+    constexpr static float s_velocitySmoothing = 0.5;
+
 protected:
     
     void updateMatrices();
     void updateTiles();
+    void updateVelocity(float _dt);
+    void updatePrefetchTiles();
+
+    /* Adds the tiles covering the view area, as seen from @_position at @_zoom, to @_tiles */
+    void rasterizeTiles(const glm::dvec2& _position, float _zoom, std::set<TileID>& _tiles) const;
 
     std::unique_ptr<MapProjection> m_projection;
     std::set<TileID> m_visibleTiles;
+    std::set<TileID> m_prefetchTiles;
 
     glm::dvec3 m_pos;
 
@@ -157,6 +191,13 @@ protected:
 
     bool m_dirty;
     bool m_changed;
+    bool m_prefetchChanged = false;
+
+    glm::dvec2 m_lastPos; // Position at the last update, to estimate velocity
+    float m_lastZoom;
+    glm::dvec2 m_velocity = glm::dvec2(0.0);
+    float m_zoomVelocity = 0.f;
+    float m_prefetchTime = 0.3f;
     
 };
 
@@ -1,6 +1,7 @@
 #ifdef PLATFORM_IOS
 
 #import <Foundation/Foundation.h>
+#import <algorithm>
 #import <utility>
 #import <cstdio>
 #import <cstdarg>
@@ -103,7 +104,12 @@ unsigned char* bytesFromResource(const char* _path, unsigned int* _size) {
     return reinterpret_cast<unsigned char *>(cdata);
 }
 
-bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
+// NSURLSessionTask priorities range from 0 to 1, with higher values served first
+static float taskPriority(float _priority) {
+    return 1.f / (1.f + std::max(_priority, 0.f));
+}
+
+bool startUrlRequest(const std::string& _url, UrlCallback _callback, float _priority) {
 
     NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
     
@@ -121,6 +127,11 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
             
             logMsg("ERROR: response \"%s\" with error \"%s\".\n", response, std::string([error.localizedDescription UTF8String]).c_str());
 
+            // Canceled tasks don't call back
+            if (error.code != NSURLErrorCancelled) {
+                _callback(std::vector<char>());
+            }
+
         }
         
     };
@@ -128,12 +139,28 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     NSURLSessionDataTask* dataTask = [defaultSession dataTaskWithURL:[NSURL URLWithString:nsUrl]
                                                     completionHandler:handler];
     
+    dataTask.priority = taskPriority(_priority);
+    
     [dataTask resume];
     
     return true;
 
 }
 
+void setUrlRequestPriority(const std::string& _url, float _priority) {
+
+    NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
+    float priority = taskPriority(_priority);
+
+    [defaultSession getTasksWithCompletionHandler:^(NSArray* dataTasks, NSArray* uploadTasks, NSArray* downloadTasks) {
+        for(NSURLSessionTask* task in dataTasks) {
+            if([[task originalRequest].URL.absoluteString isEqualToString:nsUrl]) {
+                task.priority = priority;
+            }
+        }
+    }];
+}
+
 void cancelUrlRequest(const std::string& _url) {
     
     NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
@@ -172,6 +172,7 @@ int main(void) {
     }
     
     Tangram::teardown();
+    finishUrlRequests();
     curl_global_cleanup();
     glfwTerminate();
     return 0;
@@ -7,16 +7,23 @@
 #include <string>
 #include <list>
 
-#include "urlWorker.h"
+#include "urlClient.h"
 #include "platform.h"
 #include "gl.h"
 
-#define NUM_WORKERS 3
+#define MAX_CONNECTIONS 6
+#define MAX_REQUESTS 12
 
 static bool s_isContinuousRendering = false;
 
-static UrlWorker s_Workers[NUM_WORKERS];
-static std::list<std::unique_ptr<UrlTask>> s_urlTaskQueue;
+static std::unique_ptr<UrlClient> s_urlClient;
+
+static UrlClient& getUrlClient() {
+    if (!s_urlClient) {
+        s_urlClient.reset(new UrlClient(MAX_CONNECTIONS, MAX_REQUESTS));
+    }
+    return *s_urlClient;
+}
 
 void logMsg(const char* fmt, ...) {
     va_list args;
@@ -27,32 +34,18 @@ void logMsg(const char* fmt, ...) {
 
 void processNetworkQueue() {
 
-    // check if any of the workers is done
-    {
-        for(auto& worker : s_Workers) {
-            if(worker.isFinished() && !worker.isAvailable()) {
-                auto result = worker.getResult();
-                worker.reset();
-                if(result->content.size() != 0) {
-                    result->callback(std::move(result->content));
-                }
-            }
-        }
+    if (s_urlClient) {
+        s_urlClient->processResponses();
     }
 
-    // attach workers to NetWorkerData
-    {
-        auto taskItr = s_urlTaskQueue.begin();
-        for(auto& worker : s_Workers) {
-            if(taskItr == s_urlTaskQueue.end()) {
-                break;
-            }
-            if(worker.isAvailable()) {
-                worker.perform(std::move(*taskItr));
-                taskItr = s_urlTaskQueue.erase(taskItr);
-            }
-        }
+}
+
+void finishUrlRequests() {
+
+    if (s_urlClient) {
+        s_urlClient->stop();
     }
+
 }
 
 void requestRender() {
@@ -115,31 +108,27 @@ unsigned char* bytesFromResource(const char* _path, unsigned int* _size) {
     return reinterpret_cast<unsigned char *>(cdata);
 }
 
-bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
+bool startUrlRequest(const std::string& _url, UrlCallback _callback, float _priority) {
 
-    std::unique_ptr<UrlTask> task(new UrlTask(_url, _callback));
-    for(auto& worker : s_Workers) {
-        if(worker.isAvailable()) {
-            worker.perform(std::move(task)); 
-            return true;
-        }
-    }
-    s_urlTaskQueue.push_back(std::move(task));
+    getUrlClient().addRequest(_url, _callback, _priority);
     return true;
 
 }
 
+void setUrlRequestPriority(const std::string& _url, float _priority) {
+
+    if (s_urlClient) {
+        s_urlClient->setRequestPriority(_url, _priority);
+    }
+
+}
+
 void cancelUrlRequest(const std::string& _url) {
 
-    // Only clear this request if a worker has not started operating on it!! otherwise it gets too convoluted with curl!
-    auto itr = s_urlTaskQueue.begin();
-    while(itr != s_urlTaskQueue.end()) {
-        if((*itr)->url == _url) {
-            itr = s_urlTaskQueue.erase(itr);
-        } else {
-            itr++;
-        }
+    if (s_urlClient) {
+        s_urlClient->cancelRequest(_url);
     }
+
 }
 
 #endif
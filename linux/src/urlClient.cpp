@@ -0,0 +1,385 @@
+#include "urlClient.h"
+#include "util/bufferPool.h"
+
+#include <algorithm>
+#include <curl/curl.h>
+
+// curl_multi_poll and curl_multi_wakeup let the network thread sleep until there is work to do; with
+// older versions of libcurl it checks for new requests at a short interval instead
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define HAS_CURL_WAKEUP
+#endif
+
+static const int s_waitTimeoutMs = 1000;
+static const int s_pollIntervalMs = 20;
+
+size_t UrlClient::writeData(void* _buffer, size_t _size, size_t _nmemb, void* _task) {
+
+    const size_t realSize = _size * _nmemb;
+
+    Task* task = static_cast<Task*>(_task);
+    std::vector<char>& content = task->content;
+
+    if (content.empty()) {
+        // Size the buffer for the whole response when the server tells its length
+#if LIBCURL_VERSION_NUM >= 0x073700
+        curl_off_t length = -1;
+        curl_easy_getinfo(task->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+#else
+        double length = -1;
+        curl_easy_getinfo(task->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+#endif
+        if (length > 0 && (size_t)length > content.capacity()) {
+            content.reserve((size_t)length);
+        }
+    }
+
+    content.insert(content.end(), (const char*)_buffer, (const char*)_buffer + realSize);
+
+    return realSize;
+}
+
+UrlClient::UrlClient(int _maxConnections, int _maxRequests) :
+    m_maxConnections(_maxConnections), m_maxRequests(_maxRequests) {
+
+    m_multi = curl_multi_init();
+
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)m_maxConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)m_maxConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, (long)m_maxConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    m_thread = std::thread(&UrlClient::run, this);
+
+}
+
+UrlClient::~UrlClient() {
+
+    stop();
+
+}
+
+void UrlClient::addRequest(const std::string& _url, UrlCallback _callback, float _priority) {
+
+    std::unique_ptr<Task> task(new Task());
+    task->url = _url;
+    task->callback = _callback;
+    task->priority = _priority;
+    task->content = BufferPool::GetInstance().acquire();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_stop) {
+            return;
+        }
+
+        m_newTasks.push_back(std::move(task));
+    }
+
+    wakeUp();
+
+}
+
+void UrlClient::setRequestPriority(const std::string& _url, float _priority) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_stop) {
+            return;
+        }
+
+        for (auto& task : m_newTasks) {
+            if (task->url == _url) {
+                task->priority = _priority;
+            }
+        }
+
+        m_priorityUpdates.emplace_back(_url, _priority);
+    }
+
+    wakeUp();
+
+}
+
+void UrlClient::cancelRequest(const std::string& _url) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_stop) {
+            return;
+        }
+
+        auto hasUrl = [&](const std::unique_ptr<Task>& _task) { return _task->url == _url; };
+
+        // Requests that did not start yet and responses that were not yet processed are just dropped
+        m_newTasks.erase(std::remove_if(m_newTasks.begin(), m_newTasks.end(), hasUrl), m_newTasks.end());
+        m_responses.erase(std::remove_if(m_responses.begin(), m_responses.end(), hasUrl), m_responses.end());
+
+        m_canceledUrls.push_back(_url);
+    }
+
+    wakeUp();
+
+}
+
+void UrlClient::processResponses() {
+
+    std::deque<std::unique_ptr<Task>> responses;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(responses, m_responses);
+    }
+
+    for (auto& task : responses) {
+        task->callback(std::move(task->content));
+    }
+
+}
+
+void UrlClient::stop() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_stop) {
+            return;
+        }
+
+        m_stop = true;
+        m_newTasks.clear();
+        m_responses.clear();
+    }
+
+    wakeUp();
+
+    m_thread.join();
+
+    for (auto& task : m_activeTasks) {
+        curl_multi_remove_handle(m_multi, task->handle);
+        curl_easy_cleanup(task->handle);
+    }
+    m_activeTasks.clear();
+    m_waitingTasks.clear();
+
+    for (auto handle : m_idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+    m_idleHandles.clear();
+
+    curl_multi_cleanup(m_multi);
+    m_multi = nullptr;
+
+}
+
+void UrlClient::run() {
+
+    while (true) {
+
+        std::deque<std::unique_ptr<Task>> newTasks;
+        std::vector<std::string> canceledUrls;
+        std::vector<std::pair<std::string, float>> priorityUpdates;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stop) {
+                return;
+            }
+
+            std::swap(newTasks, m_newTasks);
+            std::swap(canceledUrls, m_canceledUrls);
+            std::swap(priorityUpdates, m_priorityUpdates);
+        }
+
+        // Cancellations only apply to requests that were started before them, so they are handled first
+        for (auto& url : canceledUrls) {
+            for (auto it = m_waitingTasks.begin(); it != m_waitingTasks.end(); ) {
+                if ((*it)->url == url) {
+                    BufferPool::GetInstance().release(std::move((*it)->content));
+                    it = m_waitingTasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            for (auto it = m_activeTasks.begin(); it != m_activeTasks.end(); ) {
+                if ((*it)->url == url) {
+                    curl_multi_remove_handle(m_multi, (*it)->handle);
+                    releaseHandle((*it)->handle);
+                    BufferPool::GetInstance().release(std::move((*it)->content));
+                    it = m_activeTasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        for (auto& task : newTasks) {
+            m_waitingTasks.push_back(std::move(task));
+        }
+
+        for (auto& update : priorityUpdates) {
+            for (auto& task : m_waitingTasks) {
+                if (task->url == update.first) {
+                    task->priority = update.second;
+                }
+            }
+        }
+
+        startWaitingTasks();
+
+        int running = 0;
+        curl_multi_perform(m_multi, &running);
+
+        CURLMsg* message;
+        int remaining;
+        while ((message = curl_multi_info_read(m_multi, &remaining))) {
+            if (message->msg == CURLMSG_DONE) {
+                CURLcode result = message->data.result;
+                if (result != CURLE_OK) {
+                    char* url = nullptr;
+                    curl_easy_getinfo(message->easy_handle, CURLINFO_EFFECTIVE_URL, &url);
+                    logMsg("Fetching URL %s failed: %s\n", url ? url : "", curl_easy_strerror(result));
+                }
+                finishTask(message->easy_handle, result == CURLE_OK);
+            }
+        }
+
+        // Requests that can start after others finished don't wait for the next network event
+        if (!m_waitingTasks.empty() && (int)m_activeTasks.size() < m_maxRequests) {
+            continue;
+        }
+
+#ifdef HAS_CURL_WAKEUP
+        curl_multi_poll(m_multi, nullptr, 0, s_waitTimeoutMs, nullptr);
+#else
+        curl_multi_wait(m_multi, nullptr, 0, running > 0 ? s_pollIntervalMs : s_pollIntervalMs * 5, nullptr);
+#endif
+    }
+
+}
+
+void UrlClient::startWaitingTasks() {
+
+    while (!m_waitingTasks.empty() && (int)m_activeTasks.size() < m_maxRequests) {
+
+        auto next = std::min_element(m_waitingTasks.begin(), m_waitingTasks.end(),
+                                     [](const std::unique_ptr<Task>& _a, const std::unique_ptr<Task>& _b) {
+                                         return _a->priority < _b->priority;
+                                     });
+
+        std::unique_ptr<Task> task = std::move(*next);
+        m_waitingTasks.erase(next);
+
+        startTask(std::move(task));
+    }
+
+}
+
+void UrlClient::startTask(std::unique_ptr<Task> _task) {
+
+    CURL* handle;
+
+    // Reused handles keep their DNS cache
+    if (!m_idleHandles.empty()) {
+        handle = m_idleHandles.back();
+        m_idleHandles.pop_back();
+        curl_easy_reset(handle);
+    } else {
+        handle = curl_easy_init();
+    }
+
+    if (!handle) {
+        logMsg("ERROR: Cannot create a request for %s\n", _task->url.c_str());
+        respond(std::move(_task));
+        return;
+    }
+
+    curl_easy_setopt(handle, CURLOPT_URL, _task->url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeData);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, _task.get());
+    curl_easy_setopt(handle, CURLOPT_HEADER, 0L);
+    curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+
+    // Wait for a connection that can be multiplexed rather than opening a new one
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
+    _task->handle = handle;
+
+    if (curl_multi_add_handle(m_multi, handle) != CURLM_OK) {
+        logMsg("ERROR: Cannot start the request for %s\n", _task->url.c_str());
+        releaseHandle(handle);
+        _task->handle = nullptr;
+        respond(std::move(_task));
+        return;
+    }
+
+    m_activeTasks.push_back(std::move(_task));
+
+}
+
+void UrlClient::finishTask(CURL* _handle, bool _success) {
+
+    auto it = std::find_if(m_activeTasks.begin(), m_activeTasks.end(),
+                           [&](const std::unique_ptr<Task>& _task) { return _task->handle == _handle; });
+
+    curl_multi_remove_handle(m_multi, _handle);
+    releaseHandle(_handle);
+
+    if (it == m_activeTasks.end()) {
+        return;
+    }
+
+    std::unique_ptr<Task> task = std::move(*it);
+    m_activeTasks.erase(it);
+
+    if (!_success || task->content.empty()) {
+        // Failures are reported with empty data
+        BufferPool::GetInstance().release(std::move(task->content));
+        task->content.clear();
+        logMsg("ERROR: Request for %s failed\n", task->url.c_str());
+    }
+
+    task->handle = nullptr;
+
+    respond(std::move(task));
+
+}
+
+void UrlClient::respond(std::unique_ptr<Task> _task) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_responses.push_back(std::move(_task));
+    }
+
+    requestRender();
+
+}
+
+void UrlClient::releaseHandle(CURL* _handle) {
+
+    if ((int)m_idleHandles.size() < m_maxConnections) {
+        m_idleHandles.push_back(_handle);
+    } else {
+        curl_easy_cleanup(_handle);
+    }
+
+}
+
+void UrlClient::wakeUp() {
+
+#ifdef HAS_CURL_WAKEUP
+    curl_multi_wakeup(m_multi);
+#endif
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "platform.h"
+
+typedef void CURL;
+typedef void CURLM;
+
+/* Fetches URLs with libcurl on a single network thread
+ *
+ * All transfers run on one curl multi handle, which keeps connections to a host alive between requests
+ * and multiplexes requests over one connection when the server speaks HTTP/2. Requests that can't run
+ * yet wait in a queue ordered by priority, which can change while they wait, so that the most urgent
+ * requests are started first. Requests can be started, reprioritized and canceled from any thread;
+ * canceling a request that is in flight aborts the transfer. Responses
+ * are collected on the network thread and handed to their callbacks by <processResponses>, so that
+ * callbacks run on the thread that calls it.
+ */
+class UrlClient {
+
+public:
+
+    /* Creates a client with at most @_maxConnections open connections that runs at most @_maxRequests
+     * requests at a time; with HTTP/2, several requests share a connection */
+    UrlClient(int _maxConnections, int _maxRequests);
+
+    /* Aborts all requests and stops the network thread */
+    ~UrlClient();
+
+    /* Starts fetching @_url, with lower @_priority values first; @_callback is called with the content,
+     * or with empty content if the request fails */
+    void addRequest(const std::string& _url, UrlCallback _callback, float _priority);
+
+    /* Sets the priority of requests for @_url that have not started yet */
+    void setRequestPriority(const std::string& _url, float _priority);
+
+    /* Aborts all requests for @_url, dropping any response that was not yet processed */
+    void cancelRequest(const std::string& _url);
+
+    /* Calls the callbacks of all requests that finished since the last call */
+    void processResponses();
+
+    /* Aborts all requests and stops the network thread; no requests can be made afterwards */
+    void stop();
+
+private:
+
+    struct Task {
+        std::string url;
+        UrlCallback callback;
+        std::vector<char> content;
+        CURL* handle = nullptr;
+        float priority = 0;
+    };
+
+    static size_t writeData(void* _buffer, size_t _size, size_t _nmemb, void* _task);
+
+    void run();
+
+    void startWaitingTasks();
+    void startTask(std::unique_ptr<Task> _task);
+    void finishTask(CURL* _handle, bool _success);
+
+    /* Queues the callback of @_task for <processResponses>; empty content reports a failure */
+    void respond(std::unique_ptr<Task> _task);
+    void releaseHandle(CURL* _handle);
+
+    void wakeUp();
+
+    CURLM* m_multi = nullptr;
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::deque<std::unique_ptr<Task>> m_newTasks;
+    std::vector<std::string> m_canceledUrls;
+    std::vector<std::pair<std::string, float>> m_priorityUpdates;
+    std::deque<std::unique_ptr<Task>> m_responses;
+    bool m_stop = false;
+
+    // Only used by the network thread
+    std::vector<std::unique_ptr<Task>> m_waitingTasks;
+    std::list<std::unique_ptr<Task>> m_activeTasks;
+    std::vector<CURL*> m_idleHandles;
+
+    int m_maxConnections;
+    int m_maxRequests;
+
+};
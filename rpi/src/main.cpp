@@ -64,6 +64,7 @@ int main(int argc, char **argv){
     }
     
     Tangram::teardown();
+    finishUrlRequests();
     curl_global_cleanup();
     closeGL();
     return 0;
@@ -0,0 +1,132 @@
+#include "util/tileIndex.h"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Compares TileIndex with the std::map previously used for the tile set of TileManager,
+// on the operations done per frame: proxy lookups for each tile, in-order iteration,
+// and replacing part of the set as the view moves
+
+struct Tile { int proxyCounter = 0; };
+
+using TileMap = std::map<TileID, std::shared_ptr<Tile>>;
+using TileSet = TileIndex<std::shared_ptr<Tile>>;
+
+static const int kIterations = 2000;
+
+// Tiles of a pitched view: a trapezoid of tiles at z16 with coarser tiles towards the horizon
+static std::vector<TileID> makeTiles(int _offset) {
+
+    std::vector<TileID> tiles;
+
+    for (int lod = 0; lod < 4; lod++) {
+        int z = 16 - lod;
+        int rows = 12;
+        for (int row = 0; row < rows; row++) {
+            int width = 8 + row;
+            for (int col = -width; col < width; col++) {
+                int x = ((32768 + _offset) >> lod) + col;
+                int y = ((32768 >> lod) - rows * (lod + 1)) + row;
+                tiles.emplace_back(x, y, z);
+            }
+        }
+    }
+
+    return tiles;
+}
+
+template <typename Find>
+static int proxyLookups(const std::vector<TileID>& _tiles, Find _find) {
+
+    int found = 0;
+
+    for (const auto& id : _tiles) {
+        if (_find(id.getParent())) { found++; }
+        for (int i = 0; i < 4; i++) {
+            if (_find(id.getChild(i))) { found++; }
+        }
+    }
+
+    return found;
+}
+
+template <typename F>
+static double measure(const char* _name, F _f) {
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    long result = 0;
+    for (int i = 0; i < kIterations; i++) {
+        result += _f(i);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / kIterations;
+
+    printf("  %-28s %10.2f us/frame (%ld)\n", _name, us, result);
+    return us;
+}
+
+int main() {
+
+    std::vector<TileID> tiles = makeTiles(0);
+    std::vector<TileID> moved = makeTiles(3);
+
+    printf("%zu tiles, %d frames\n", tiles.size(), kIterations);
+
+    TileMap map;
+    TileSet index;
+
+    for (const auto& id : tiles) {
+        map[id] = std::make_shared<Tile>();
+        index[id] = std::make_shared<Tile>();
+    }
+
+    printf("proxy lookups (parent and 4 children per tile)\n");
+
+    measure("std::map", [&](int) {
+        return proxyLookups(tiles, [&](const TileID& _id) { return map.find(_id) != map.end(); });
+    });
+    measure("TileIndex", [&](int) {
+        return proxyLookups(tiles, [&](const TileID& _id) { return index.find(_id) != nullptr; });
+    });
+
+    printf("ordered iteration\n");
+
+    measure("std::map", [&](int) {
+        int sum = 0;
+        for (const auto& entry : map) { sum += entry.second->proxyCounter + 1; }
+        return sum;
+    });
+    measure("TileIndex", [&](int) {
+        int sum = 0;
+        for (const auto& entry : index) { sum += entry.second->proxyCounter + 1; }
+        return sum;
+    });
+
+    printf("view update (replace tiles, then proxy lookups and iteration)\n");
+
+    measure("std::map", [&](int _i) {
+        const auto& add = (_i % 2) ? tiles : moved;
+        const auto& remove = (_i % 2) ? moved : tiles;
+        for (const auto& id : remove) { map.erase(id); }
+        for (const auto& id : add) { map[id] = std::make_shared<Tile>(); }
+        int sum = proxyLookups(add, [&](const TileID& _id) { return map.find(_id) != map.end(); });
+        for (const auto& entry : map) { sum += entry.second->proxyCounter; }
+        return sum;
+    });
+    measure("TileIndex", [&](int _i) {
+        const auto& add = (_i % 2) ? tiles : moved;
+        const auto& remove = (_i % 2) ? moved : tiles;
+        for (const auto& id : remove) { index.erase(id); }
+        for (const auto& id : add) { index[id] = std::make_shared<Tile>(); }
+        int sum = proxyLookups(add, [&](const TileID& _id) { return index.find(_id) != nullptr; });
+        for (const auto& entry : index) { sum += entry.second->proxyCounter; }
+        return sum;
+    });
+
+    return 0;
+}
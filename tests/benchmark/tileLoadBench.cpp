@@ -0,0 +1,467 @@
+#include "tangram.h"
+#include "platform.h"
+#include "gl.h"
+#include "data/mvtSource.h"
+#include "data/geoJsonSource.h"
+#include "tile/tileManager.h"
+#include "util/memoryTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Drives Tangram along scripted camera paths against synthetic tile sources, without any network
+// access, and reports frame times, the time until new tiles are first drawn, and peak memory.
+//
+// usage: tileLoadBench.out [density]
+//
+// Tiles are generated procedurally from their TileID as MVT and as GeoJSON, with about 'density'
+// (default 1.0) times a few hundred features per tile. The sources provide the data layers of the
+// default scene, so they are styled by config.yaml. Tiles are generated when they are parsed, so
+// parse times include the generation of the tile.
+
+static const int kWidth = 800;
+static const int kHeight = 600;
+static const float kFrameTime = 1.f / 60.f; // Time step of the scripted camera motion
+static const int kSettleFrames = 90;        // Frames without motion at the end of each path
+
+// Geometry of a synthetic feature in tile coordinates, in [0, 1] with y down
+struct SyntheticFeature {
+    int type; // 1: point, 2: line, 3: polygon, as in MVT
+    std::vector<std::vector<std::pair<double, double>>> parts;
+    std::string kind;
+    float height;
+};
+
+struct SyntheticLayer {
+    const char* name;
+    std::vector<SyntheticFeature> features;
+};
+
+static std::vector<SyntheticLayer> generateTile(const TileID& _id, float _density) {
+
+    std::minstd_rand rng((_id.x * 73856093) ^ (_id.y * 19349663) ^ (_id.z * 83492791));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    auto count = [&](int _base) { return std::max(1, (int)std::lround(_base * _density)); };
+
+    auto box = [](double _x, double _y, double _w, double _h) {
+        return std::vector<std::pair<double, double>> {
+            { _x, _y }, { _x + _w, _y }, { _x + _w, _y + _h }, { _x, _y + _h }, { _x, _y }
+        };
+    };
+
+    std::vector<SyntheticLayer> layers = {
+        { "earth", {} }, { "landuse", {} }, { "water", {} }, { "roads", {} }, { "buildings", {} }
+    };
+
+    layers[0].features.push_back({ 3, { box(0, 0, 1, 1) }, "earth", 0 });
+
+    for (int i = 0; i < count(8); i++) {
+        double w = 0.05 + 0.2 * unit(rng);
+        layers[1].features.push_back({ 3, { box(unit(rng) * (1 - w), unit(rng) * (1 - w), w, w) }, "park", 0 });
+    }
+
+    for (int i = 0; i < count(3); i++) {
+        // Irregular lake with a hole
+        double cx = 0.2 + 0.6 * unit(rng), cy = 0.2 + 0.6 * unit(rng), r = 0.05 + 0.1 * unit(rng);
+        std::vector<std::pair<double, double>> outer, inner;
+        for (int j = 0; j <= 24; j++) {
+            double a = 2 * M_PI * (j % 24) / 24;
+            double k = 0.8 + 0.2 * std::sin(5 * a);
+            outer.emplace_back(cx + r * k * std::cos(a), cy + r * k * std::sin(a));
+            inner.emplace_back(cx + 0.3 * r * std::cos(-a), cy + 0.3 * r * std::sin(-a));
+        }
+        layers[2].features.push_back({ 3, { outer, inner }, "lake", 0 });
+    }
+
+    for (int i = 0; i < count(60); i++) {
+        // Roads cross the tile boundaries, so that they are clipped like real tile data
+        std::vector<std::pair<double, double>> line;
+        double x = unit(rng) * 1.2 - 0.1, y = unit(rng) * 1.2 - 0.1;
+        double angle = unit(rng) * 2 * M_PI;
+        for (int j = 0; j < 8; j++) {
+            line.emplace_back(x, y);
+            angle += (unit(rng) - 0.5) * 0.6;
+            x += 0.05 * std::cos(angle);
+            y += 0.05 * std::sin(angle);
+        }
+        layers[3].features.push_back({ 2, { line }, i % 4 == 0 ? "major_road" : "minor_road", 0 });
+    }
+
+    for (int i = 0; i < count(200); i++) {
+        double w = 0.005 + 0.01 * unit(rng);
+        layers[4].features.push_back({ 3, { box(unit(rng) * (1 - w), unit(rng) * (1 - w), w, w) }, "building",
+                                       float(5 + 40 * unit(rng)) });
+    }
+
+    return layers;
+}
+
+// Minimal encoder of the Mapbox vector tile format, for the fields read by PbfParser
+
+static void writeVarint(std::string& _out, uint64_t _value) {
+    while (_value >= 0x80) {
+        _out.push_back(char((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back(char(_value));
+}
+
+static void writeKey(std::string& _out, int _field, int _wireType) {
+    writeVarint(_out, (_field << 3) | _wireType);
+}
+
+static void writeBytes(std::string& _out, int _field, const std::string& _bytes) {
+    writeKey(_out, _field, 2);
+    writeVarint(_out, _bytes.size());
+    _out.append(_bytes);
+}
+
+static uint32_t zigzag(int32_t _value) {
+    return (uint32_t(_value) << 1) ^ uint32_t(_value >> 31);
+}
+
+static std::string encodeGeometry(const SyntheticFeature& _feature, int _extent) {
+
+    std::string geometry;
+    int32_t cx = 0, cy = 0;
+
+    for (const auto& part : _feature.parts) {
+        // Rings are closed with a command instead of repeating their first point
+        bool closed = _feature.type == 3;
+        size_t n = closed ? part.size() - 1 : part.size();
+
+        for (size_t i = 0; i < n; i++) {
+            if (i == 0) { writeVarint(geometry, (1 << 3) | 1); }       // moveTo
+            if (i == 1) { writeVarint(geometry, ((n - 1) << 3) | 2); } // lineTo
+            int32_t x = int32_t(std::lround(part[i].first * _extent));
+            int32_t y = int32_t(std::lround(part[i].second * _extent));
+            writeVarint(geometry, zigzag(x - cx));
+            writeVarint(geometry, zigzag(y - cy));
+            cx = x;
+            cy = y;
+        }
+
+        if (closed) { writeVarint(geometry, (1 << 3) | 7); } // closePath
+    }
+
+    return geometry;
+}
+
+static std::vector<char> encodeMvt(const std::vector<SyntheticLayer>& _layers) {
+
+    const int extent = 4096;
+    std::string tile;
+
+    for (const auto& layer : _layers) {
+
+        // Values are the distinct kinds followed by the heights of the features that have one
+        std::vector<std::string> kinds;
+        std::vector<float> heights;
+
+        for (const auto& feature : layer.features) {
+            if (std::find(kinds.begin(), kinds.end(), feature.kind) == kinds.end()) {
+                kinds.push_back(feature.kind);
+            }
+        }
+
+        std::string layerMsg;
+        writeKey(layerMsg, 15, 0);
+        writeVarint(layerMsg, 2);
+        writeBytes(layerMsg, 1, layer.name);
+
+        for (const auto& feature : layer.features) {
+
+            std::string tags;
+            writeVarint(tags, 0);
+            writeVarint(tags, std::find(kinds.begin(), kinds.end(), feature.kind) - kinds.begin());
+            if (feature.height > 0) {
+                writeVarint(tags, 1);
+                writeVarint(tags, kinds.size() + heights.size());
+                heights.push_back(feature.height);
+            }
+
+            std::string featureMsg;
+            writeBytes(featureMsg, 2, tags);
+            writeKey(featureMsg, 3, 0);
+            writeVarint(featureMsg, feature.type);
+            writeBytes(featureMsg, 4, encodeGeometry(feature, extent));
+
+            writeBytes(layerMsg, 2, featureMsg);
+        }
+
+        writeBytes(layerMsg, 3, "kind");
+        writeBytes(layerMsg, 3, "height");
+
+        for (const auto& kind : kinds) {
+            std::string value;
+            writeBytes(value, 1, kind);
+            writeBytes(layerMsg, 4, value);
+        }
+
+        for (float height : heights) {
+            std::string value;
+            char bytes[4];
+            std::memcpy(bytes, &height, 4);
+            writeKey(value, 2, 5);
+            value.append(bytes, 4);
+            writeBytes(layerMsg, 4, value);
+        }
+
+        writeKey(layerMsg, 5, 0);
+        writeVarint(layerMsg, extent);
+
+        writeBytes(tile, 3, layerMsg);
+    }
+
+    return std::vector<char>(tile.begin(), tile.end());
+}
+
+static std::vector<char> encodeGeoJson(const std::vector<SyntheticLayer>& _layers, const TileID& _id) {
+
+    double n = std::pow(2.0, _id.z);
+
+    auto lonLat = [&](const std::pair<double, double>& _p, char* _buffer, size_t _size) {
+        double lon = (_id.x + _p.first) / n * 360.0 - 180.0;
+        double lat = std::atan(std::sinh(M_PI * (1 - 2 * (_id.y + _p.second) / n))) * 180.0 / M_PI;
+        snprintf(_buffer, _size, "[%.7f,%.7f]", lon, lat);
+    };
+
+    std::string json = "{";
+    char buffer[64];
+
+    for (size_t l = 0; l < _layers.size(); l++) {
+
+        json += (l > 0 ? ",\"" : "\"") + std::string(_layers[l].name) + "\":{\"type\":\"FeatureCollection\",\"features\":[";
+
+        const auto& features = _layers[l].features;
+        for (size_t f = 0; f < features.size(); f++) {
+            const auto& feature = features[f];
+
+            json += f > 0 ? "," : "";
+            json += "{\"type\":\"Feature\",\"properties\":{\"kind\":\"" + feature.kind + "\"";
+            if (feature.height > 0) {
+                snprintf(buffer, sizeof(buffer), ",\"height\":%.1f", feature.height);
+                json += buffer;
+            }
+            json += feature.type == 3 ? "},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":["
+                                      : "},\"geometry\":{\"type\":\"LineString\",\"coordinates\":";
+
+            for (size_t p = 0; p < feature.parts.size(); p++) {
+                json += p > 0 ? ",[" : "[";
+                for (size_t i = 0; i < feature.parts[p].size(); i++) {
+                    lonLat(feature.parts[p][i], buffer, sizeof(buffer));
+                    json += i > 0 ? "," : "";
+                    json += buffer;
+                }
+                json += "]";
+                if (feature.type != 3) { break; }
+            }
+
+            json += feature.type == 3 ? "]}}" : "}}";
+        }
+
+        json += "]}";
+    }
+
+    json += "}";
+
+    return std::vector<char>(json.begin(), json.end());
+}
+
+// Sources that queue tiles right away and generate their content when parsed by the tile workers
+
+template <class Source>
+class SyntheticSource : public Source {
+
+public:
+
+    SyntheticSource(const std::string& _name, float _density, bool _mvt) :
+        Source(_name, "synthetic/{z}/{x}/{y}"), m_density(_density), m_mvt(_mvt) {}
+
+    virtual bool loadTileData(const TileID& _tileID, TileManager& _tileManager) override {
+
+        std::shared_ptr<TileData> tileData = this->getTileData(_tileID);
+
+        if (tileData) {
+            _tileManager.addToWorkerQueue(tileData, _tileID, this);
+        } else {
+            _tileManager.addToWorkerQueue(std::vector<char>(), _tileID, this);
+        }
+
+        return true;
+    }
+
+    virtual void cancelLoadingTile(const TileID& _tileID) override {}
+
+protected:
+
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData, const CancelToken& _cancel) const override {
+
+        auto layers = generateTile(_tile.getID(), m_density);
+        std::vector<char> data = m_mvt ? encodeMvt(layers) : encodeGeoJson(layers, _tile.getID());
+
+        return Source::parse(_tile, data, _cancel);
+    }
+
+private:
+
+    float m_density;
+    bool m_mvt;
+
+};
+
+// Scripted camera motion, one step per frame
+
+struct CameraPath {
+    const char* name;
+    int frames;
+    std::function<void(int)> step;
+};
+
+static std::vector<CameraPath> makePaths() {
+
+    const float cx = 0.5f * kWidth, cy = 0.5f * kHeight;
+
+    return {
+        { "pan", 240, [=](int) {
+            Tangram::handlePanGesture(cx, cy, cx - 6.f, cy - 2.f);
+        } },
+        { "fling", 120, [=](int _frame) {
+            float speed = 80.f * std::pow(0.96f, _frame);
+            Tangram::handlePanGesture(cx, cy, cx + speed, cy + 0.3f * speed);
+        } },
+        { "zoom in", 150, [=](int) {
+            Tangram::handlePinchGesture(cx, cy, 1.02f);
+        } },
+        { "zoom out", 150, [=](int) {
+            Tangram::handlePinchGesture(cx, cy, 1.f / 1.02f);
+        } },
+        { "pitch", 120, [=](int _frame) {
+            Tangram::handleShoveGesture(_frame < 60 ? 0.01f : -0.01f);
+        } }
+    };
+}
+
+static double percentile(std::vector<double> _samples, double _percentile) {
+
+    if (_samples.empty()) { return 0; }
+
+    std::sort(_samples.begin(), _samples.end());
+    size_t index = std::min(_samples.size() - 1, size_t(_percentile * _samples.size()));
+
+    return _samples[index];
+}
+
+static size_t peakResidentBytes() {
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024;
+#endif
+}
+
+static void runBenchmark(const char* _format, std::unique_ptr<DataSource> _source, GLFWwindow* _window) {
+
+    Tangram::clearDataSources();
+    Tangram::addDataSource(std::move(_source));
+    Tangram::setViewPosition(-74.00976419448854, 40.70532700869127);
+
+    TileStats::GetInstance().reset();
+
+    printf("\n%s tiles\n", _format);
+    printf("  %-10s %8s %8s %8s %8s %8s\n", "path", "frames", "p50 ms", "p90 ms", "p99 ms", "max ms");
+
+    size_t peakTracked = 0;
+    std::vector<double> allFrames;
+
+    for (const auto& path : makePaths()) {
+
+        std::vector<double> frames;
+
+        for (int i = 0; i < path.frames + kSettleFrames; i++) {
+
+            auto start = std::chrono::steady_clock::now();
+
+            if (i < path.frames) {
+                path.step(i);
+            }
+
+            Tangram::update(kFrameTime);
+            Tangram::render();
+            glFinish();
+
+            auto end = std::chrono::steady_clock::now();
+            frames.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+            peakTracked = std::max(peakTracked, MemoryTracker::GetInstance().getTotalUsage());
+
+            glfwSwapBuffers(_window);
+            glfwPollEvents();
+        }
+
+        printf("  %-10s %8zu %8.2f %8.2f %8.2f %8.2f\n", path.name, frames.size(), percentile(frames, 0.5),
+               percentile(frames, 0.9), percentile(frames, 0.99), percentile(frames, 1.0));
+
+        allFrames.insert(allFrames.end(), frames.begin(), frames.end());
+    }
+
+    printf("  %-10s %8zu %8.2f %8.2f %8.2f %8.2f\n", "all", allFrames.size(), percentile(allFrames, 0.5),
+           percentile(allFrames, 0.9), percentile(allFrames, 0.99), percentile(allFrames, 1.0));
+
+    printf("  tile stages (ms)   %8s %8s %8s %8s\n", "tiles", "p50", "p90", "max");
+    for (int stage = 0; stage < (int)TileStage::count; stage++) {
+        const Histogram& histogram = Tangram::getStats().getHistogram((TileStage)stage);
+        printf("  %-18s %8zu %8.2f %8.2f %8.2f\n", TileStats::getStageName((TileStage)stage), histogram.getCount(),
+               histogram.getPercentile(0.5), histogram.getPercentile(0.9), histogram.getMax());
+    }
+
+    printf("  peak tracked memory %.1f MB, peak resident memory %.1f MB\n",
+           peakTracked / (1024. * 1024.), peakResidentBytes() / (1024. * 1024.));
+}
+
+int main(int argc, char** argv) {
+
+    float density = argc > 1 ? std::atof(argv[1]) : 1.f;
+
+    if (!glfwInit()) {
+        return -1;
+    }
+
+    // Frames are rendered into a hidden window, so that the benchmark needs no interaction
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* window = glfwCreateWindow(kWidth, kHeight, "Tangram benchmark", NULL, NULL);
+    if (!window) {
+        glfwTerminate();
+        return -1;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    Tangram::initialize();
+    Tangram::resize(kWidth, kHeight);
+
+    printf("density %.2f, %d x %d\n", density, kWidth, kHeight);
+
+    runBenchmark("MVT", std::unique_ptr<DataSource>(new SyntheticSource<MVTSource>("osm", density, true)), window);
+    runBenchmark("GeoJSON", std::unique_ptr<DataSource>(new SyntheticSource<GeoJsonSource>("osm", density, false)), window);
+
+    Tangram::teardown();
+    glfwTerminate();
+
+    return 0;
+}
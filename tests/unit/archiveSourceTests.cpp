@@ -0,0 +1,133 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "data/archiveSource.h"
+#include "tile/mapTile.h"
+#include "util/cancelToken.h"
+#include "util/mapProjection.h"
+
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+static const char* s_archivePath = "./test.tgta";
+
+// Vector tile with a layer named @_layer holding a single point
+static std::vector<char> makeTile(const std::string& _layer) {
+
+    std::vector<char> feature = { 0x18, 0x01, 0x22, 0x03, 0x09, 0x32, 0x22 }; // type point, geometry
+    std::vector<char> layer = { 0x78, 0x02, 0x0a, (char)_layer.size() };      // version 2, name
+    layer.insert(layer.end(), _layer.begin(), _layer.end());
+    layer.push_back(0x12);                                                     // feature
+    layer.push_back((char)feature.size());
+    layer.insert(layer.end(), feature.begin(), feature.end());
+    layer.insert(layer.end(), { 0x28, (char)0x80, 0x20 });                     // extent 4096
+
+    std::vector<char> tile = { 0x1a, (char)layer.size() };
+    tile.insert(tile.end(), layer.begin(), layer.end());
+
+    return tile;
+}
+
+static std::vector<char> gzip(const std::vector<char>& _data) {
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    std::vector<char> out(deflateBound(&stream, _data.size()) + 32);
+    stream.next_in = (Bytef*)_data.data();
+    stream.avail_in = _data.size();
+    stream.next_out = (Bytef*)out.data();
+    stream.avail_out = out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return out;
+}
+
+static void writeUint32(std::vector<char>& _out, uint32_t _value) {
+    for (int i = 0; i < 4; i++) { _out.push_back((char)(_value >> (8 * i))); }
+}
+
+struct Entry {
+    int z, x, y;
+    std::vector<char> data;
+};
+
+// Writes an archive with @_entries, which must be in the order of the format: z, x, y ascending
+static void writeArchive(const std::vector<Entry>& _entries, const char* _magic = "TGTA") {
+
+    std::vector<char> file(_magic, _magic + 4);
+    writeUint32(file, 1);
+    writeUint32(file, _entries.size());
+
+    uint64_t offset = 12 + 24 * _entries.size();
+    for (const auto& entry : _entries) {
+        writeUint32(file, entry.z);
+        writeUint32(file, entry.x);
+        writeUint32(file, entry.y);
+        writeUint32(file, entry.data.size());
+        writeUint32(file, (uint32_t)offset);
+        writeUint32(file, (uint32_t)(offset >> 32));
+        offset += entry.data.size();
+    }
+    for (const auto& entry : _entries) {
+        file.insert(file.end(), entry.data.begin(), entry.data.end());
+    }
+
+    std::FILE* out = std::fopen(s_archivePath, "wb");
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+}
+
+static std::vector<std::string> readLayers(DataSource& _source, const TileID& _tileID) {
+
+    MercatorProjection projection;
+    MapTile tile(_tileID, projection);
+    std::vector<char> buffer;
+
+    std::shared_ptr<TileData> data = _source.parse(tile, buffer, CancelToken::none());
+
+    std::vector<std::string> layers;
+    for (const auto& layer : data->layers) {
+        if (layer.features.size() == 1) {
+            layers.push_back(layer.name);
+        }
+    }
+    return layers;
+}
+
+TEST_CASE( "Find plain and gzipped tiles in an archive", "[Core][ArchiveSource]" ) {
+
+    writeArchive({
+        { 0, 0, 0, makeTile("zero") },
+        { 1, 0, 1, gzip(makeTile("gzipped")) },
+        { 1, 1, 0, makeTile("one") },
+        { 2, 3, 3, makeTile("two") }
+    });
+
+    ArchiveSource source("archive", s_archivePath);
+
+    REQUIRE(readLayers(source, TileID(0, 0, 0)) == std::vector<std::string>{ "zero" });
+    REQUIRE(readLayers(source, TileID(0, 1, 1)) == std::vector<std::string>{ "gzipped" });
+    REQUIRE(readLayers(source, TileID(1, 0, 1)) == std::vector<std::string>{ "one" });
+    REQUIRE(readLayers(source, TileID(3, 3, 2)) == std::vector<std::string>{ "two" });
+
+    // Tiles that are not in the archive have no data
+    REQUIRE(readLayers(source, TileID(1, 1, 1)).empty());
+
+    std::remove(s_archivePath);
+}
+
+TEST_CASE( "Provide no tiles from an archive with a corrupt header", "[Core][ArchiveSource]" ) {
+
+    writeArchive({ { 0, 0, 0, makeTile("zero") } }, "XXXX");
+
+    ArchiveSource source("archive", s_archivePath);
+
+    REQUIRE(readLayers(source, TileID(0, 0, 0)).empty());
+
+    std::remove(s_archivePath);
+}
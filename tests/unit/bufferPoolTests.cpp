@@ -0,0 +1,33 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/bufferPool.h"
+
+TEST_CASE( "Reuse released buffers", "[Core][BufferPool]" ) {
+
+    BufferPool& pool = BufferPool::GetInstance();
+    pool.clear();
+
+    std::vector<char> buffer = pool.acquire(1000);
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer.capacity() >= 1000);
+
+    buffer.assign(500, 'a');
+    const char* data = buffer.data();
+
+    pool.release(std::move(buffer));
+    REQUIRE(pool.getPooledBytes() >= 1000);
+
+    // A smaller request gets the released buffer back, emptied
+    std::vector<char> reused = pool.acquire(100);
+    REQUIRE(reused.empty());
+    REQUIRE(reused.data() == data);
+    REQUIRE(pool.getPooledBytes() == 0);
+
+    pool.release(std::move(reused));
+
+    // Buffers over the size limit are not kept
+    pool.clear();
+    pool.release(std::vector<char>(BufferPool::s_maxBufferSize + 1));
+    REQUIRE(pool.getPooledBytes() == 0);
+}
@@ -0,0 +1,180 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/clipping.h"
+
+TEST_CASE( "Clip a line leaving and entering the bounds", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    Line line = { { -2.f, 0.f, 0.f }, { 0.f, 0.f, 0.f }, { 0.f, 2.f, 0.f }, { 0.5f, 2.f, 0.f }, { 0.5f, 0.f, 0.f } };
+    std::vector<Line> clipped;
+
+    Clipping::clipLine(line, bounds, clipped);
+
+    REQUIRE(clipped.size() == 2);
+    REQUIRE(clipped[0].size() == 3);
+    REQUIRE(clipped[0][0].x == Approx(-1.f));
+    REQUIRE(clipped[0][2].y == Approx(1.f));
+    REQUIRE(clipped[1].size() == 2);
+    REQUIRE(clipped[1][0].y == Approx(1.f));
+    REQUIRE(clipped[1][1].y == Approx(0.f));
+
+}
+
+TEST_CASE( "Clip a polygon to the bounds", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    // Closed square overlapping the upper right corner of the bounds
+    Polygon polygon = { { { 0.f, 0.f, 0.f }, { 2.f, 0.f, 0.f }, { 2.f, 2.f, 0.f }, { 0.f, 2.f, 0.f }, { 0.f, 0.f, 0.f } } };
+    Polygon clipped;
+
+    Clipping::clipPolygon(polygon, bounds, clipped);
+
+    REQUIRE(clipped.size() == 1);
+    REQUIRE(clipped[0].size() == 5);
+    REQUIRE(clipped[0].front() == clipped[0].back());
+    for (const auto& point : clipped[0]) {
+        REQUIRE(Clipping::containsPoint(bounds, point));
+    }
+
+    Polygon outside = { { { 2.f, 2.f, 0.f }, { 3.f, 2.f, 0.f }, { 3.f, 3.f, 0.f } } };
+    Clipping::clipPolygon(outside, bounds, clipped);
+
+    REQUIRE(clipped.empty());
+
+}
+
+TEST_CASE( "Clip each outer ring of a multipolygon on its own", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    // Two outer rings, wound alike, the first outside of the bounds; the second has a hole, wound the other way
+    Polygon polygon = {
+        { { 2.f, 2.f, 0.f }, { 3.f, 2.f, 0.f }, { 3.f, 3.f, 0.f }, { 2.f, 3.f, 0.f }, { 2.f, 2.f, 0.f } },
+        { { -0.5f, -0.5f, 0.f }, { 1.5f, -0.5f, 0.f }, { 1.5f, 0.5f, 0.f }, { -0.5f, 0.5f, 0.f }, { -0.5f, -0.5f, 0.f } },
+        { { -0.25f, -0.25f, 0.f }, { -0.25f, 0.25f, 0.f }, { 0.25f, 0.25f, 0.f }, { 0.25f, -0.25f, 0.f }, { -0.25f, -0.25f, 0.f } },
+        // A third outer ring outside of the bounds, dropped with its hole
+        { { 2.f, -3.f, 0.f }, { 3.f, -3.f, 0.f }, { 3.f, -2.f, 0.f }, { 2.f, -2.f, 0.f }, { 2.f, -3.f, 0.f } },
+        { { 2.5f, -2.5f, 0.f }, { 2.5f, -2.4f, 0.f }, { 2.6f, -2.4f, 0.f }, { 2.5f, -2.5f, 0.f } }
+    };
+    Polygon clipped;
+
+    Clipping::clipPolygon(polygon, bounds, clipped);
+
+    REQUIRE(clipped.size() == 2);
+    REQUIRE(clipped[0].size() == 5);
+    for (const auto& point : clipped[0]) {
+        REQUIRE(Clipping::containsPoint(bounds, point));
+    }
+    REQUIRE(clipped[1] == polygon[2]);
+
+}
+
+TEST_CASE( "Find how a line overlaps the bounds", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    Line inside = { { -0.5f, -0.5f, 0.f }, { 1.f, 0.5f, 0.f } };
+    Line partial = { { 0.f, 0.f, 0.f }, { 2.f, 0.f, 0.f } };
+    Line outside = { { 2.f, -3.f, 0.f }, { 3.f, 3.f, 0.f } };
+
+    // Judged by the bounding box, so a line around a corner overlaps although it misses the bounds
+    Line corner = { { 0.f, 3.f, 0.f }, { 3.f, 0.f, 0.f } };
+
+    REQUIRE(Clipping::getOverlap(inside, bounds) == Clipping::Overlap::inside);
+    REQUIRE(Clipping::getOverlap(partial, bounds) == Clipping::Overlap::partial);
+    REQUIRE(Clipping::getOverlap(outside, bounds) == Clipping::Overlap::outside);
+    REQUIRE(Clipping::getOverlap(corner, bounds) == Clipping::Overlap::partial);
+
+}
+
+TEST_CASE( "Grow the tile bounds by a fraction of the tile size", "[Core][Clipping]" ) {
+
+    glm::vec4 tile = Clipping::getTileBounds(0.f);
+    REQUIRE(tile.x == -1.f);
+    REQUIRE(tile.w == 1.f);
+
+    glm::vec4 buffered = Clipping::getTileBounds(0.25f);
+    REQUIRE(buffered.x == -1.5f);
+    REQUIRE(buffered.y == -1.5f);
+    REQUIRE(buffered.z == 1.5f);
+    REQUIRE(buffered.w == 1.5f);
+
+}
+
+TEST_CASE( "Clip a feature in place", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    Feature feature;
+    feature.props.stringProps["name"] = "feature";
+    feature.points = { { 0.f, 0.f, 0.f }, { 2.f, 0.f, 0.f } };
+    feature.lines = {
+        { { -0.5f, 0.f, 0.f }, { 0.5f, 0.f, 0.f } },   // inside
+        { { 0.f, 0.5f, 0.f }, { 2.f, 0.5f, 0.f } },    // leaving the bounds
+        { { 2.f, 2.f, 0.f }, { 3.f, 3.f, 0.f } }       // outside
+    };
+    feature.polygons = {
+        { { { 0.f, 0.f, 0.f }, { 2.f, 0.f, 0.f }, { 2.f, 2.f, 0.f }, { 0.f, 2.f, 0.f }, { 0.f, 0.f, 0.f } } },
+        { { { 2.f, 2.f, 0.f }, { 3.f, 2.f, 0.f }, { 3.f, 3.f, 0.f }, { 2.f, 2.f, 0.f } } }
+    };
+
+    Feature copy;
+    REQUIRE(Clipping::clipFeature(feature, bounds, copy));
+    REQUIRE(Clipping::clipFeature(feature, bounds));
+
+    REQUIRE(feature.points.size() == 1);
+    REQUIRE(feature.lines.size() == 2);
+    REQUIRE(feature.lines[0][1].x == Approx(0.5f));
+    REQUIRE(feature.lines[1][1].x == Approx(1.f));
+    REQUIRE(feature.polygons.size() == 1);
+    for (const auto& point : feature.polygons[0][0]) {
+        REQUIRE(Clipping::containsPoint(bounds, point));
+    }
+    REQUIRE(feature.props.stringProps["name"] == "feature");
+
+    // Both overloads clip alike
+    REQUIRE(copy.points == feature.points);
+    REQUIRE(copy.lines == feature.lines);
+    REQUIRE(copy.polygons == feature.polygons);
+
+    // Nothing is left of a feature outside of the bounds
+    Feature outside;
+    outside.points = { { 2.f, 2.f, 0.f } };
+    REQUIRE(!Clipping::clipFeature(outside, bounds));
+    REQUIRE(outside.points.empty());
+
+}
+
+TEST_CASE( "Clip a feature by all rings of its polygons", "[Core][Clipping]" ) {
+
+    glm::vec4 bounds(-1.f, -1.f, 1.f, 1.f);
+
+    Line inside = { { 0.f, 0.f, 0.f }, { 0.5f, 0.f, 0.f }, { 0.5f, 0.5f, 0.f }, { 0.f, 0.f, 0.f } };
+    Line across = { { 0.f, -0.5f, 0.f }, { 3.f, -0.5f, 0.f }, { 3.f, -0.25f, 0.f }, { 0.f, -0.5f, 0.f } };
+    Line outside = { { 2.f, 2.f, 0.f }, { 3.f, 2.f, 0.f }, { 3.f, 3.f, 0.f }, { 2.f, 2.f, 0.f } };
+
+    REQUIRE(Clipping::getOverlap(Polygon{ inside, inside }, bounds) == Clipping::Overlap::inside);
+    REQUIRE(Clipping::getOverlap(Polygon{ outside, outside }, bounds) == Clipping::Overlap::outside);
+    REQUIRE(Clipping::getOverlap(Polygon{ inside, outside }, bounds) == Clipping::Overlap::partial);
+
+    // The first outer ring inside of the bounds; the second reaches out of them and is clipped
+    Feature feature;
+    feature.polygons = { { inside, across } };
+    REQUIRE(Clipping::clipFeature(feature, bounds));
+    REQUIRE(feature.polygons.size() == 1);
+    REQUIRE(feature.polygons[0].size() == 2);
+    for (const auto& point : feature.polygons[0][1]) {
+        REQUIRE(Clipping::containsPoint(bounds, point));
+    }
+
+    // The first outer ring outside of the bounds; the second is kept
+    feature.polygons = { { outside, inside } };
+    REQUIRE(Clipping::clipFeature(feature, bounds));
+    REQUIRE(feature.polygons.size() == 1);
+    REQUIRE(feature.polygons[0].size() == 1);
+    REQUIRE(feature.polygons[0][0] == inside);
+
+}
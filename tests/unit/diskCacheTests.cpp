@@ -0,0 +1,170 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "data/diskCache.h"
+
+#include <cstdio>
+
+static void removeCacheFiles() {
+    std::remove("./tiles.dat");
+    std::remove("./tiles.idx");
+}
+
+static std::vector<char> makeData(size_t _size, char _value) {
+    return std::vector<char>(_size, _value);
+}
+
+static std::vector<char> read(DiskCache& _cache, const std::string& _url) {
+
+    std::vector<char> result;
+
+    if (_cache.get(_url, nullptr, TileID(0, 0, 0), [&](std::vector<char>&& _data) { result = std::move(_data); })) {
+        _cache.flush();
+    }
+
+    return result;
+}
+
+TEST_CASE( "Store and read back tile data", "[Core][DiskCache]" ) {
+
+    removeCacheFiles();
+
+    DiskCache cache(".", 1024);
+    REQUIRE(cache.open());
+
+    REQUIRE(!cache.contains("a"));
+    REQUIRE(read(cache, "a").empty());
+
+    cache.put("a", makeData(100, 'a'));
+    cache.put("b", makeData(50, 'b'));
+    cache.flush();
+
+    REQUIRE(cache.contains("a"));
+    REQUIRE(cache.getSize() == 150);
+    REQUIRE(read(cache, "a") == makeData(100, 'a'));
+    REQUIRE(read(cache, "b") == makeData(50, 'b'));
+
+    // Replacing an entry drops the previous data
+    cache.put("a", makeData(20, 'c'));
+    cache.flush();
+
+    REQUIRE(cache.getSize() == 70);
+    REQUIRE(read(cache, "a") == makeData(20, 'c'));
+
+    removeCacheFiles();
+}
+
+TEST_CASE( "Evict least recently used data over the size cap", "[Core][DiskCache]" ) {
+
+    removeCacheFiles();
+
+    DiskCache cache(".", 100);
+    REQUIRE(cache.open());
+
+    cache.put("a", makeData(40, 'a'));
+    cache.put("b", makeData(40, 'b'));
+    cache.flush();
+
+    // Reading "a" makes "b" the least recently used entry
+    REQUIRE(read(cache, "a").size() == 40);
+
+    // Enough writes to compact the data file
+    for (int i = 0; i < 4; i++) {
+        cache.put("c", makeData(40, 'c' + i));
+        cache.flush();
+    }
+
+    REQUIRE(cache.contains("a"));
+    REQUIRE(!cache.contains("b"));
+    REQUIRE(cache.getSize() == 80);
+    REQUIRE(read(cache, "a") == makeData(40, 'a'));
+    REQUIRE(read(cache, "c") == makeData(40, 'f'));
+
+    removeCacheFiles();
+}
+
+TEST_CASE( "Keep data across instances and expire old data", "[Core][DiskCache]" ) {
+
+    removeCacheFiles();
+
+    {
+        DiskCache cache(".", 1024);
+        REQUIRE(cache.open());
+        cache.put("a", makeData(10, 'a'));
+    }
+
+    {
+        DiskCache cache(".", 1024);
+        REQUIRE(cache.open());
+        REQUIRE(cache.contains("a"));
+        REQUIRE(read(cache, "a") == makeData(10, 'a'));
+    }
+
+    {
+        // Any stored data is older than a nanosecond
+        DiskCache cache(".", 1024, 1e-9);
+        REQUIRE(cache.open());
+        REQUIRE(!cache.contains("a"));
+        REQUIRE(read(cache, "a").empty());
+    }
+
+    removeCacheFiles();
+}
+
+TEST_CASE( "Cancel the reads of one tile only", "[Core][DiskCache]" ) {
+
+    removeCacheFiles();
+
+    DiskCache cache(".", 1024);
+    REQUIRE(cache.open());
+
+    cache.put("a", makeData(10, 'a'));
+    cache.flush();
+
+    std::vector<char> first, second;
+    int owner = 0;
+
+    // Two tiles waiting for the same URL, e.g. overzoomed siblings; a pending write keeps the reads queued
+    cache.put("b", makeData(1000, 'b'));
+    cache.get("a", &owner, TileID(0, 0, 1), [&](std::vector<char>&& _data) { first = std::move(_data); });
+    cache.get("a", &owner, TileID(1, 0, 1), [&](std::vector<char>&& _data) { second = std::move(_data); });
+    cache.cancel("a", &owner, TileID(0, 0, 1));
+    cache.flush();
+
+    REQUIRE(second == makeData(10, 'a'));
+
+    removeCacheFiles();
+}
+
+TEST_CASE( "Call back with empty data for entries evicted before the read", "[Core][DiskCache]" ) {
+
+    removeCacheFiles();
+
+    DiskCache cache(".", 1024);
+    REQUIRE(cache.open());
+
+    cache.put("a", makeData(100, 'a'));
+    cache.flush();
+
+    bool called = false;
+    std::vector<char> data(1, 'x');
+
+    // The write, queued before the read, evicts the entry
+    cache.put("b", makeData(1000, 'b'));
+    REQUIRE(cache.get("a", nullptr, TileID(0, 0, 0), [&](std::vector<char>&& _data) { called = true; data = std::move(_data); }));
+    cache.flush();
+
+    REQUIRE(called);
+    REQUIRE(data.empty());
+
+    // Reads still pending when the cache is cleared are called back too
+    called = false;
+    cache.put("c", makeData(1000, 'c'));
+    if (cache.get("b", nullptr, TileID(0, 0, 0), [&](std::vector<char>&& _data) { called = true; })) {
+        cache.clear();
+        cache.flush();
+        REQUIRE(called);
+    }
+
+    removeCacheFiles();
+}
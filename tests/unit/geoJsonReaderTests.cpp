@@ -0,0 +1,208 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/geoJson.h"
+#include "util/geoJsonReader.h"
+#include "util/mapProjection.h"
+
+#include "rapidjson/document.h"
+#include "rapidjson/reader.h"
+
+#include <cmath>
+
+static MercatorProjection s_projection;
+
+// Reads @_json, a tile of layers or a single feature collection, with the streaming reader
+static std::shared_ptr<TileData> readStreaming(const std::string& _json, const MapTile& _tile,
+                                               const CancelToken& _cancel = CancelToken::none(), bool* _error = nullptr) {
+
+    auto data = std::make_shared<TileData>();
+    GeoJsonReader handler(*data, _tile, _cancel, "collection");
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(_json.c_str());
+
+    reader.Parse(stream, handler);
+
+    if (_error) {
+        *_error = reader.HasParseError();
+    }
+
+    return data;
+}
+
+// Reads @_json the same way with a DOM and the GeoJson functions
+static std::shared_ptr<TileData> readDocument(const std::string& _json, const MapTile& _tile) {
+
+    auto data = std::make_shared<TileData>();
+    rapidjson::Document doc;
+    doc.Parse(_json.c_str());
+
+    if (doc.HasMember("type")) {
+        data->layers.emplace_back("collection");
+        GeoJson::extractLayer(doc, data->layers.back(), _tile);
+        return data;
+    }
+
+    for (auto layer = doc.MemberBegin(); layer != doc.MemberEnd(); ++layer) {
+        data->layers.emplace_back(std::string(layer->name.GetString()));
+        GeoJson::extractLayer(layer->value, data->layers.back(), _tile);
+    }
+
+    return data;
+}
+
+static bool equal(const Line& _a, const Line& _b) {
+
+    if (_a.size() != _b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < _a.size(); i++) {
+        if (std::abs(_a[i].x - _b[i].x) > 1e-5f || std::abs(_a[i].y - _b[i].y) > 1e-5f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void requireEqual(const std::shared_ptr<TileData>& _a, const std::shared_ptr<TileData>& _b) {
+
+    REQUIRE(_a->layers.size() == _b->layers.size());
+
+    for (size_t l = 0; l < _a->layers.size(); l++) {
+
+        const auto& featuresA = _a->layers[l].features;
+        const auto& featuresB = _b->layers[l].features;
+
+        REQUIRE(_a->layers[l].name == _b->layers[l].name);
+        REQUIRE(featuresA.size() == featuresB.size());
+
+        for (size_t f = 0; f < featuresA.size(); f++) {
+
+            const Feature& a = featuresA[f];
+            const Feature& b = featuresB[f];
+
+            REQUIRE(a.geometryType == b.geometryType);
+            REQUIRE(equal(a.points, b.points));
+
+            REQUIRE(a.lines.size() == b.lines.size());
+            for (size_t i = 0; i < a.lines.size(); i++) {
+                REQUIRE(equal(a.lines[i], b.lines[i]));
+            }
+
+            REQUIRE(a.polygons.size() == b.polygons.size());
+            for (size_t i = 0; i < a.polygons.size(); i++) {
+                REQUIRE(a.polygons[i].size() == b.polygons[i].size());
+                for (size_t j = 0; j < a.polygons[i].size(); j++) {
+                    REQUIRE(equal(a.polygons[i][j], b.polygons[i][j]));
+                }
+            }
+
+            REQUIRE(a.props.stringProps == b.props.stringProps);
+            REQUIRE(a.props.numericProps == b.props.numericProps);
+        }
+    }
+}
+
+static const char* s_features = R"(
+    { "type": "Feature", "properties": { "name": "point", "height": 10 },
+      "geometry": { "type": "Point", "coordinates": [ 1.5, 2.5 ] } },
+    { "type": "Feature", "properties": { "kind": "points" },
+      "geometry": { "type": "MultiPoint", "coordinates": [ [ 1, 2 ], [ -3, 4 ] ] } },
+    { "type": "Feature", "properties": { "min_height": 2, "width": 1.5 },
+      "geometry": { "type": "LineString", "coordinates": [ [ 0, 0 ], [ 10, 10 ], [ 20, 0 ] ] } },
+    { "type": "Feature", "properties": {},
+      "geometry": { "type": "MultiLineString", "coordinates": [ [ [ 0, 0 ], [ 1, 1 ] ], [ [ 2, 2 ], [ 3, 3 ], [ 4, 2 ] ] ] } },
+    { "type": "Feature", "properties": { "name": "square" },
+      "geometry": { "type": "Polygon", "coordinates": [ [ [ 0, 0 ], [ 10, 0 ], [ 10, 10 ], [ 0, 0 ] ],
+                                                        [ [ 2, 2 ], [ 3, 2 ], [ 3, 3 ], [ 2, 2 ] ] ] } },
+    { "type": "Feature", "properties": { "name": "squares" },
+      "geometry": { "type": "MultiPolygon", "coordinates": [ [ [ [ 0, 0 ], [ 1, 0 ], [ 1, 1 ], [ 0, 0 ] ] ],
+                                                             [ [ [ 5, 5 ], [ 6, 5 ], [ 6, 6 ], [ 5, 5 ] ] ] ] } }
+)";
+
+TEST_CASE( "Read every geometry type like the GeoJson functions", "[Core][GeoJsonReader]" ) {
+
+    MapTile tile(TileID(0, 0, 0), s_projection);
+
+    std::string json = std::string(R"({ "layer": { "type": "FeatureCollection", "features": [)") + s_features + "] } }";
+
+    auto streamed = readStreaming(json, tile);
+
+    REQUIRE(streamed->layers.size() == 1);
+    REQUIRE(streamed->layers[0].features.size() == 6);
+    requireEqual(streamed, readDocument(json, tile));
+}
+
+TEST_CASE( "Read a bare feature collection into one layer", "[Core][GeoJsonReader]" ) {
+
+    MapTile tile(TileID(1, 1, 2), s_projection);
+
+    std::string json = std::string(R"({ "type": "FeatureCollection", "features": [)") + s_features + "] }";
+
+    auto streamed = readStreaming(json, tile);
+
+    REQUIRE(streamed->layers.size() == 1);
+    REQUIRE(streamed->layers[0].name == "collection");
+    requireEqual(streamed, readDocument(json, tile));
+}
+
+TEST_CASE( "Read coordinates that come before the geometry type", "[Core][GeoJsonReader]" ) {
+
+    MapTile tile(TileID(0, 0, 0), s_projection);
+
+    std::string json = R"({ "layer": { "features": [
+        { "geometry": { "coordinates": [ [ [ 0, 0 ], [ 10, 0 ], [ 10, 10 ], [ 0, 0 ] ] ], "type": "Polygon" },
+          "properties": { "name": "late type" }, "type": "Feature" },
+        { "geometry": { "coordinates": [ [ 0, 0 ], [ 5, 5 ] ], "type": "LineString" }, "properties": {} }
+    ] } })";
+
+    auto streamed = readStreaming(json, tile);
+
+    REQUIRE(streamed->layers[0].features.size() == 2);
+    REQUIRE(streamed->layers[0].features[0].polygons.size() == 1);
+    requireEqual(streamed, readDocument(json, tile));
+}
+
+TEST_CASE( "Skip nested property values", "[Core][GeoJsonReader]" ) {
+
+    MapTile tile(TileID(0, 0, 0), s_projection);
+
+    std::string json = R"({ "layer": { "features": [
+        { "properties": { "nested": { "coordinates": [ 9, 9 ], "name": "inner", "deeper": { "a": [ 1, [ 2 ] ] } },
+                          "list": [ 1, "two", { "three": 3 } ], "name": "outer", "rank": 3 },
+          "geometry": { "type": "Point", "coordinates": [ 1, 1 ] } }
+    ] } })";
+
+    auto streamed = readStreaming(json, tile);
+
+    REQUIRE(streamed->layers[0].features.size() == 1);
+    const Properties& props = streamed->layers[0].features[0].props;
+    REQUIRE(props.stringProps.size() == 1);
+    REQUIRE(props.stringProps.at("name") == "outer");
+    REQUIRE(props.numericProps.size() == 1);
+    REQUIRE(streamed->layers[0].features[0].points.size() == 1);
+    requireEqual(streamed, readDocument(json, tile));
+}
+
+TEST_CASE( "Stop reading once canceled", "[Core][GeoJsonReader]" ) {
+
+    MapTile tile(TileID(0, 0, 0), s_projection);
+
+    std::string json = R"({ "layer": { "features": [)";
+    for (int i = 0; i < 100; i++) {
+        json += std::string(i > 0 ? "," : "") + R"({ "properties": {}, "geometry": { "type": "Point", "coordinates": [ 1, 1 ] } })";
+    }
+    json += "] } }";
+
+    bool error = false;
+    auto complete = readStreaming(json, tile, CancelToken::none(), &error);
+    REQUIRE(!error);
+    REQUIRE(complete->layers[0].features.size() == 100);
+
+    CancelToken cancel;
+    cancel.cancel();
+
+    auto partial = readStreaming(json, tile, cancel, &error);
+    REQUIRE(error);
+    REQUIRE(partial->layers[0].features.size() < 100);
+}
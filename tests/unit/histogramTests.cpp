@@ -0,0 +1,43 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/histogram.h"
+
+TEST_CASE( "Histogram counts samples in logarithmic buckets", "[Core][Histogram]" ) {
+
+    Histogram histogram;
+
+    REQUIRE(histogram.getCount() == 0);
+    REQUIRE(histogram.getPercentile(0.5) == 0);
+
+    histogram.add(0.1);
+    histogram.add(1.0);
+    histogram.add(3.0);
+    histogram.add(100.0);
+
+    REQUIRE(histogram.getCount() == 4);
+    REQUIRE(histogram.getMin() == 0.1);
+    REQUIRE(histogram.getMax() == 100.0);
+    REQUIRE(histogram.getMean() == Approx(26.025));
+
+    REQUIRE(histogram.getBucketCount(0) == 1);
+    REQUIRE(histogram.getBucketCount(3) == 1); // (0.5, 1]
+    REQUIRE(histogram.getBucketCount(5) == 1); // (2, 4]
+
+    REQUIRE(histogram.getPercentile(0.5) == 1.0);
+    REQUIRE(histogram.getPercentile(0.75) == 4.0);
+    REQUIRE(histogram.getPercentile(1.0) == 100.0);
+
+    Histogram other;
+    other.add(0.01);
+    histogram.merge(other);
+
+    REQUIRE(histogram.getCount() == 5);
+    REQUIRE(histogram.getMin() == 0.01);
+    REQUIRE(histogram.getBucketCount(0) == 2);
+
+    histogram.clear();
+    REQUIRE(histogram.getCount() == 0);
+    REQUIRE(histogram.getMax() == 0);
+
+}
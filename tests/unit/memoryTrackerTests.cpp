@@ -0,0 +1,69 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/memoryTracker.h"
+#include <algorithm>
+#include <vector>
+
+TEST_CASE( "TrackedMemory reports its bytes for its lifetime", "[Core][MemoryTracker]" ) {
+
+    auto& tracker = MemoryTracker::GetInstance();
+    size_t before = tracker.getUsage(MemoryCategory::meshData);
+
+    {
+        TrackedMemory memory(MemoryCategory::meshData);
+        memory.set(100);
+        REQUIRE(tracker.getUsage(MemoryCategory::meshData) == before + 100);
+
+        memory.set(40);
+        REQUIRE(tracker.getUsage(MemoryCategory::meshData) == before + 40);
+    }
+
+    REQUIRE(tracker.getUsage(MemoryCategory::meshData) == before);
+
+}
+
+TEST_CASE( "Eviction handlers run by stage until usage fits the budget", "[Core][MemoryTracker]" ) {
+
+    auto& tracker = MemoryTracker::GetInstance();
+
+    TrackedMemory data(MemoryCategory::tileData);
+    TrackedMemory tiles(MemoryCategory::gpuBuffers);
+    data.set(300);
+    tiles.set(500);
+
+    std::vector<EvictionStage> calls;
+
+    int tilesHandler = tracker.addEvictionHandler(EvictionStage::tiles, [&](size_t _bytes) {
+        calls.push_back(EvictionStage::tiles);
+        size_t freed = std::min(_bytes, tiles.get());
+        tiles.set(tiles.get() - freed);
+        return freed;
+    });
+
+    int dataHandler = tracker.addEvictionHandler(EvictionStage::tileData, [&](size_t _bytes) {
+        calls.push_back(EvictionStage::tileData);
+        size_t freed = data.get();
+        data.set(0);
+        return freed;
+    });
+
+    tracker.setBudget(tracker.getTotalUsage() - 200);
+    tracker.enforceBudget();
+
+    // Releasing tile data was enough
+    REQUIRE(calls.size() == 1);
+    REQUIRE(calls[0] == EvictionStage::tileData);
+
+    tracker.setBudget(tracker.getTotalUsage() - 100);
+    tracker.enforceBudget();
+
+    REQUIRE(calls.size() == 3);
+    REQUIRE(calls[2] == EvictionStage::tiles);
+    REQUIRE(tiles.get() == 400);
+
+    tracker.removeEvictionHandler(tilesHandler);
+    tracker.removeEvictionHandler(dataHandler);
+    tracker.setBudget(0);
+
+}
@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "data/requestCoalescer.h"
+
+#include <map>
+
+// Stands in for the platform, completing requests only when told to
+struct FakeNetwork {
+
+    std::map<std::string, UrlCallback> requests;
+    int started = 0;
+    int canceled = 0;
+
+    RequestCoalescer coalescer {
+        [this](const std::string& _url, UrlCallback _callback, float) {
+            started++;
+            requests[_url] = _callback;
+            return true;
+        },
+        [this](const std::string& _url) {
+            canceled++;
+            requests.erase(_url);
+        },
+        [](const std::string&, float) {}
+    };
+
+    void complete(const std::string& _url, std::vector<char> _data) {
+        UrlCallback callback = requests[_url];
+        requests.erase(_url);
+        callback(std::move(_data));
+    }
+
+};
+
+static const int s_owner = 0;
+
+TEST_CASE( "Share a request between tiles", "[Core][RequestCoalescer]" ) {
+
+    FakeNetwork network;
+    std::vector<char> a, b;
+
+    REQUIRE(network.coalescer.request("url", &s_owner, TileID(0, 0, 1), [&](std::vector<char>&& _data) { a = _data; }));
+    REQUIRE(network.coalescer.request("url", &s_owner, TileID(1, 0, 1), [&](std::vector<char>&& _data) { b = _data; }));
+
+    REQUIRE(network.started == 1);
+    REQUIRE(network.coalescer.getNumRequests() == 1);
+
+    network.complete("url", std::vector<char>(10, 'a'));
+
+    REQUIRE(a == std::vector<char>(10, 'a'));
+    REQUIRE(b == std::vector<char>(10, 'a'));
+    REQUIRE(network.coalescer.getNumRequests() == 0);
+}
+
+TEST_CASE( "Cancel a shared request once no tile waits for it", "[Core][RequestCoalescer]" ) {
+
+    FakeNetwork network;
+    bool calledA = false, calledB = false;
+
+    network.coalescer.request("url", &s_owner, TileID(0, 0, 1), [&](std::vector<char>&&) { calledA = true; });
+    network.coalescer.request("url", &s_owner, TileID(1, 0, 1), [&](std::vector<char>&&) { calledB = true; });
+
+    network.coalescer.cancel("url", &s_owner, TileID(0, 0, 1));
+    REQUIRE(network.canceled == 0);
+    REQUIRE(network.coalescer.getNumRequests() == 1);
+
+    network.coalescer.cancel("url", &s_owner, TileID(1, 0, 1));
+    REQUIRE(network.canceled == 1);
+    REQUIRE(network.coalescer.getNumRequests() == 0);
+
+    // A later request starts over
+    network.coalescer.request("url", &s_owner, TileID(0, 0, 1), [&](std::vector<char>&&) { calledA = true; });
+    REQUIRE(network.started == 2);
+
+    network.complete("url", std::vector<char>(1, 'a'));
+    REQUIRE(calledA);
+    REQUIRE(!calledB);
+}
+
+TEST_CASE( "Forget a failed request and tell its tiles", "[Core][RequestCoalescer]" ) {
+
+    FakeNetwork network;
+    int failures = 0;
+
+    auto callback = [&](std::vector<char>&& _data) {
+        if (_data.empty()) { failures++; }
+    };
+
+    network.coalescer.request("url", &s_owner, TileID(0, 0, 1), callback);
+    network.coalescer.request("url", &s_owner, TileID(1, 0, 1), callback);
+
+    network.complete("url", std::vector<char>());
+
+    REQUIRE(failures == 2);
+    REQUIRE(network.coalescer.getNumRequests() == 0);
+
+    // Tiles asking for the URL again get a new request instead of joining the failed one
+    std::vector<char> data;
+    network.coalescer.request("url", &s_owner, TileID(0, 0, 1), [&](std::vector<char>&& _data) { data = _data; });
+    REQUIRE(network.started == 2);
+
+    network.complete("url", std::vector<char>(5, 'b'));
+    REQUIRE(data == std::vector<char>(5, 'b'));
+}
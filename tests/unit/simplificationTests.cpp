@@ -0,0 +1,71 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/simplification.h"
+
+TEST_CASE( "Simplify a line within the tolerance", "[Core][Simplification]" ) {
+
+    Line line = { { 0.f, 0.f, 0.f }, { 1.f, 0.01f, 0.f }, { 2.f, 0.f, 0.f }, { 3.f, 1.f, 0.f }, { 4.f, 0.f, 0.f } };
+
+    Line simplified;
+    Simplification::simplifyLine(line, 0.1f, simplified);
+
+    // The point close to the first segment is removed, the peak and the end points are kept
+    REQUIRE(simplified.size() == 4);
+    REQUIRE(simplified.front() == line.front());
+    REQUIRE(simplified[1] == line[2]);
+    REQUIRE(simplified[2] == line[3]);
+    REQUIRE(simplified.back() == line.back());
+
+    // A tolerance of zero keeps every point
+    Line unchanged;
+    Simplification::simplifyLine(line, 0.f, unchanged);
+    REQUIRE(unchanged == line);
+
+}
+
+TEST_CASE( "Drop lines of a feature that collapse", "[Core][Simplification]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::LINES;
+    feature.lines = { { { 0.f, 0.f, 0.f }, { 0.5f, 0.f, 0.f }, { 1.f, 0.f, 0.f } }, { { 0.f, 0.f, 0.f } } };
+
+    REQUIRE(Simplification::simplifyFeature(feature, 0.1f));
+    REQUIRE(feature.lines.size() == 1);
+    REQUIRE(feature.lines[0].size() == 2);
+
+    Feature point;
+    point.geometryType = GeometryType::LINES;
+    point.lines = { { { 0.f, 0.f, 0.f } } };
+    REQUIRE(!Simplification::simplifyFeature(point, 0.1f));
+
+}
+
+TEST_CASE( "Drop only the collapsed outer rings of a multipolygon", "[Core][Simplification]" ) {
+
+    // Outer rings are counter-clockwise, holes clockwise
+    Line small = { { 0.f, 0.f, 0.f }, { 0.01f, 0.f, 0.f }, { 0.01f, 0.01f, 0.f }, { 0.f, 0.01f, 0.f }, { 0.f, 0.f, 0.f } };
+    Line smallHole = { { 0.002f, 0.002f, 0.f }, { 0.002f, 0.008f, 0.f }, { 0.008f, 0.008f, 0.f }, { 0.002f, 0.002f, 0.f } };
+    Line large = { { 1.f, 1.f, 0.f }, { 2.f, 1.f, 0.f }, { 2.f, 2.f, 0.f }, { 1.f, 2.f, 0.f }, { 1.f, 1.f, 0.f } };
+    Line largeHole = { { 1.2f, 1.2f, 0.f }, { 1.2f, 1.8f, 0.f }, { 1.8f, 1.8f, 0.f }, { 1.8f, 1.2f, 0.f }, { 1.2f, 1.2f, 0.f } };
+    Line collapsedHole = { { 1.5f, 1.5f, 0.f }, { 1.5f, 1.51f, 0.f }, { 1.51f, 1.51f, 0.f }, { 1.5f, 1.5f, 0.f } };
+
+    Feature feature;
+    feature.geometryType = GeometryType::POLYGONS;
+    feature.polygons = { { small, smallHole, large, largeHole, collapsedHole } };
+
+    REQUIRE(Simplification::simplifyFeature(feature, 0.05f));
+
+    // The first outer ring collapses with its hole; the second is kept with the hole that does not collapse
+    REQUIRE(feature.polygons.size() == 1);
+    REQUIRE(feature.polygons[0].size() == 2);
+    REQUIRE(feature.polygons[0][0] == large);
+    REQUIRE(feature.polygons[0][1] == largeHole);
+
+    Feature collapsed;
+    collapsed.geometryType = GeometryType::POLYGONS;
+    collapsed.polygons = { { small, smallHole } };
+    REQUIRE(!Simplification::simplifyFeature(collapsed, 0.05f));
+    REQUIRE(collapsed.polygons.empty());
+
+}
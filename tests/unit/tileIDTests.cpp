@@ -75,3 +75,25 @@ TEST_CASE( "Ensure TileIDs correctly evaluate their validity", "[Core][TileID]")
     REQUIRE(!NOT_A_TILE.isValid());
     
 }
+
+TEST_CASE( "Ensure TileIDs round-trip through their quadkeys", "[Core][TileID]") {
+
+    TileID a = TileID(5, 9, 4);
+
+    REQUIRE(TileID::fromQuadKey(a.getQuadKey()) == a);
+    REQUIRE(TileID::fromQuadKey(TileID(0, 0, 0).getQuadKey()) == TileID(0, 0, 0));
+    REQUIRE(TileID::fromQuadKey(TileID(1023, 4095, 18).getQuadKey()) == TileID(1023, 4095, 18));
+
+    // Shifting a quadkey by two bits gives the key of the parent tile
+    REQUIRE((a.getQuadKey() >> 2) == a.getParent().getQuadKey());
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE((a.getChild(i).getQuadKey() >> 2) == a.getQuadKey());
+    }
+
+    // Keys are unique across zoom levels
+    REQUIRE(TileID(0, 0, 1).getQuadKey() != TileID(0, 0, 2).getQuadKey());
+
+    REQUIRE(NOT_A_TILE.getQuadKey() == 0);
+
+}
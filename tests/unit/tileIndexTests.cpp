@@ -0,0 +1,80 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "util/tileIndex.h"
+#include <vector>
+
+TEST_CASE( "Insert, find and erase tiles in a TileIndex", "[Core][TileIndex]" ) {
+
+    TileIndex<int> index;
+
+    index[TileID(1, 2, 3)] = 1;
+    index[TileID(0, 1, 2)] = 2;
+
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.contains(TileID(1, 2, 3)));
+    REQUIRE(*index.find(TileID(0, 1, 2)) == 2);
+    REQUIRE(index.find(TileID(2, 1, 2)) == nullptr);
+
+    REQUIRE(index.erase(TileID(1, 2, 3)));
+    REQUIRE(!index.erase(TileID(1, 2, 3)));
+    REQUIRE(index.size() == 1);
+    REQUIRE(!index.contains(TileID(1, 2, 3)));
+
+}
+
+TEST_CASE( "Iterate over a TileIndex in TileID order", "[Core][TileIndex]" ) {
+
+    TileIndex<int> index;
+
+    index[TileID(1, 1, 1)] = 0;
+    index[TileID(2, 1, 2)] = 0;
+    index[TileID(1, 2, 2)] = 0;
+    index[TileID(0, 0, 0)] = 0;
+    index[TileID(1, 1, 2)] = 0;
+
+    std::vector<TileID> ids;
+    for (const auto& entry : index) {
+        ids.push_back(entry.first);
+    }
+
+    REQUIRE(ids.size() == 5);
+    for (size_t i = 1; i < ids.size(); i++) {
+        REQUIRE(ids[i - 1] < ids[i]);
+    }
+
+}
+
+TEST_CASE( "Find ancestors and descendants in a TileIndex", "[Core][TileIndex]" ) {
+
+    TileIndex<int> index;
+
+    TileID tile(4, 6, 4);
+
+    index[TileID(1, 1, 2)] = 2;
+    index[TileID(8, 12, 5)] = 5;
+    index[TileID(19, 27, 6)] = 6;
+    index[TileID(0, 0, 6)] = 0; // Not a descendant
+
+    auto ancestor = index.findAncestor(tile);
+    REQUIRE(ancestor != nullptr);
+    REQUIRE(ancestor->first == TileID(1, 1, 2));
+
+    REQUIRE(index.findAncestor(tile, 1) == nullptr);
+    REQUIRE(index.findAncestor(TileID(0, 0, 0)) == nullptr);
+
+    std::vector<TileIndex<int>::value_type*> descendants;
+    index.findDescendants(tile, 1, descendants);
+
+    REQUIRE(descendants.size() == 1);
+    REQUIRE(descendants[0]->second == 5);
+
+    descendants.clear();
+    index.findDescendants(tile, 8, descendants);
+
+    REQUIRE(descendants.size() == 2);
+    REQUIRE(descendants[1]->first == TileID(19, 27, 6));
+
+    REQUIRE(!index.hasDescendants(TileID(1, 0, 1)));
+
+}
@@ -38,6 +38,22 @@ foreach(_src_file_path ${TEST_SOURCES})
     target_link_libraries(${EXECUTABLE_NAME} core ${GLFW_LDFLAGS})
 endforeach(_src_file_path ${TEST_SOURCES})
 
+file(GLOB BENCHMARK_SOURCES tests/benchmark/*.cpp)
+
+# create an executable per benchmark
+foreach(_src_file_path ${BENCHMARK_SOURCES})
+    string(REPLACE ".cpp" "" benchmark_case ${_src_file_path})
+    string(REGEX MATCH "([^/]*)$" benchmark_name ${benchmark_case})
+
+    set(EXECUTABLE_NAME "${benchmark_name}.out")
+
+    add_executable(${EXECUTABLE_NAME} ${_src_file_path} ${OSX_PLATFORM_SRC})
+
+    set_target_properties(${EXECUTABLE_NAME} PROPERTIES COMPILE_FLAGS "-O3")
+    target_link_libraries(${EXECUTABLE_NAME} -lcurl)
+    target_link_libraries(${EXECUTABLE_NAME} core ${GLFW_LDFLAGS})
+endforeach(_src_file_path ${BENCHMARK_SOURCES})
+
 # copy resources in order to make tests with resources dependency
 file(GLOB_RECURSE RESOURCES ${PROJECT_SOURCE_DIR}/core/resources/*)
 foreach(_resource ${RESOURCES})